@@ -1,4 +1,5 @@
 #include <obs.h>
+#include <util/profiler.h>
 #include "audio-wrapper-source.h"
 
 const char *audio_wrapper_get_name(void *type_data)
@@ -20,8 +21,10 @@ void audio_wrapper_destroy(void *data)
 	bfree(data);
 }
 
-bool audio_wrapper_render(void *data, uint64_t *ts_out, struct obs_source_audio_mix *audio, uint32_t mixers, size_t channels,
-			  size_t sample_rate)
+static const char *audio_wrapper_render_name = "audio_wrapper_render";
+
+static bool audio_wrapper_render_internal(void *data, uint64_t *ts_out, struct obs_source_audio_mix *audio, uint32_t mixers,
+					  size_t channels, size_t sample_rate)
 {
 	UNUSED_PARAMETER(sample_rate);
 	struct audio_wrapper_info *aw = (struct audio_wrapper_info *)data;
@@ -64,6 +67,15 @@ bool audio_wrapper_render(void *data, uint64_t *ts_out, struct obs_source_audio_
 	return true;
 }
 
+bool audio_wrapper_render(void *data, uint64_t *ts_out, struct obs_source_audio_mix *audio, uint32_t mixers, size_t channels,
+			  size_t sample_rate)
+{
+	profile_start(audio_wrapper_render_name);
+	const bool ret = audio_wrapper_render_internal(data, ts_out, audio, mixers, channels, sample_rate);
+	profile_end(audio_wrapper_render_name);
+	return ret;
+}
+
 static void audio_wrapper_enum_sources(void *data, obs_source_enum_proc_t enum_callback, void *param, bool active)
 {
 	UNUSED_PARAMETER(active);
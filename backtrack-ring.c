@@ -0,0 +1,287 @@
+#include <obs-module.h>
+#include <util/threading.h>
+#include <util/platform.h>
+#include <util/dstr.h>
+#include "backtrack-ring.h"
+
+#define COPY_BUFFER_SIZE (1024 * 1024)
+
+struct backtrack_segment {
+	char *path;
+	uint64_t start_ns;
+	uint64_t end_ns;
+};
+
+struct backtrack_save_request {
+	char *path;
+	uint64_t window_ns;
+};
+
+struct backtrack_save_job {
+	char *path;
+	uint64_t window_ns;
+	DARRAY(char *) segments;
+	uint64_t bytes;
+};
+
+struct backtrack_ring {
+	uint64_t duration_ns;
+
+	pthread_mutex_t mutex;
+	DARRAY(struct backtrack_segment) segments;
+	struct backtrack_segment current;
+	DARRAY(struct backtrack_save_request) pending_saves;
+	DARRAY(struct backtrack_save_job) jobs;
+	long pinned;
+
+	os_sem_t *jobs_sem;
+	pthread_t thread;
+	bool thread_created;
+	bool stop;
+
+	backtrack_saved_callback_t callback;
+	void *param;
+};
+
+static volatile long ring_teardowns = 0;
+static volatile bool ring_shutdown = false;
+
+static void backtrack_ring_remove_stale(const char *directory)
+{
+	os_dir_t *dir = os_opendir(directory);
+	if (!dir)
+		return;
+	struct dstr path = {0};
+	struct os_dirent *ent;
+	while ((ent = os_readdir(dir)) != NULL) {
+		const char *ext = os_get_path_extension(ent->d_name);
+		if (ent->directory || !ext || strcmp(ext, ".ts") != 0)
+			continue;
+		dstr_printf(&path, "%s/%s", directory, ent->d_name);
+		os_unlink(path.array);
+	}
+	dstr_free(&path);
+	os_closedir(dir);
+}
+
+// drop the oldest finished segments that are no longer needed to cover the window, unless a save still reads them
+static void backtrack_ring_prune(struct backtrack_ring *ring)
+{
+	if (ring->pinned > 0)
+		return;
+	uint64_t covered = 0;
+	size_t keep = ring->segments.num;
+	while (keep > 0 && covered < ring->duration_ns) {
+		keep--;
+		struct backtrack_segment *s = ring->segments.array + keep;
+		covered += s->end_ns - s->start_ns;
+	}
+	for (size_t i = 0; i < keep; i++) {
+		os_unlink(ring->segments.array[i].path);
+		bfree(ring->segments.array[i].path);
+	}
+	if (keep)
+		da_erase_range(ring->segments, 0, keep);
+}
+
+static void backtrack_ring_queue_saves(struct backtrack_ring *ring)
+{
+	for (size_t i = 0; i < ring->pending_saves.num; i++) {
+		struct backtrack_save_request *request = ring->pending_saves.array + i;
+		struct backtrack_save_job job = {0};
+		job.path = request->path;
+		job.window_ns = request->window_ns;
+		uint64_t covered = 0;
+		size_t first = ring->segments.num;
+		while (first > 0 && covered < request->window_ns) {
+			first--;
+			covered += ring->segments.array[first].end_ns - ring->segments.array[first].start_ns;
+		}
+		for (size_t j = first; j < ring->segments.num; j++) {
+			char *segment = bstrdup(ring->segments.array[j].path);
+			da_push_back(job.segments, &segment);
+		}
+		ring->pinned++;
+		da_push_back(ring->jobs, &job);
+		os_sem_post(ring->jobs_sem);
+	}
+	da_resize(ring->pending_saves, 0);
+}
+
+static bool backtrack_ring_copy(struct backtrack_save_job *job)
+{
+	if (!job->segments.num)
+		return false;
+
+	FILE *out = os_fopen(job->path, "wb");
+	if (!out)
+		return false;
+
+	uint8_t *buffer = bmalloc(COPY_BUFFER_SIZE);
+	bool success = true;
+	for (size_t i = 0; success && i < job->segments.num; i++) {
+		FILE *in = os_fopen(job->segments.array[i], "rb");
+		if (!in) {
+			success = false;
+			break;
+		}
+		size_t read;
+		while ((read = fread(buffer, 1, COPY_BUFFER_SIZE, in)) > 0) {
+			if (os_atomic_load_bool(&ring_shutdown)) {
+				success = false;
+				break;
+			}
+			if (fwrite(buffer, 1, read, out) != read) {
+				success = false;
+				break;
+			}
+			job->bytes += read;
+		}
+		fclose(in);
+	}
+	bfree(buffer);
+	if (fclose(out) != 0)
+		success = false;
+	return success;
+}
+
+static void backtrack_ring_free(struct backtrack_ring *ring)
+{
+	for (size_t i = 0; i < ring->segments.num; i++) {
+		os_unlink(ring->segments.array[i].path);
+		bfree(ring->segments.array[i].path);
+	}
+	da_free(ring->segments);
+	if (ring->current.path) {
+		os_unlink(ring->current.path);
+		bfree(ring->current.path);
+	}
+	for (size_t i = 0; i < ring->pending_saves.num; i++)
+		bfree(ring->pending_saves.array[i].path);
+	da_free(ring->pending_saves);
+	da_free(ring->jobs);
+
+	os_sem_destroy(ring->jobs_sem);
+	pthread_mutex_destroy(&ring->mutex);
+	bfree(ring);
+}
+
+static void *backtrack_ring_thread(void *data)
+{
+	struct backtrack_ring *ring = data;
+	os_set_thread_name("vertical-backtrack-ring");
+	while (os_sem_wait(ring->jobs_sem) == 0) {
+		pthread_mutex_lock(&ring->mutex);
+		if (!ring->jobs.num) {
+			const bool stop = ring->stop;
+			pthread_mutex_unlock(&ring->mutex);
+			if (stop)
+				break;
+			continue;
+		}
+		struct backtrack_save_job job = ring->jobs.array[0];
+		da_erase(ring->jobs, 0);
+		pthread_mutex_unlock(&ring->mutex);
+
+		const uint64_t start = os_gettime_ns();
+		const bool success = backtrack_ring_copy(&job);
+		const uint64_t duration = os_gettime_ns() - start;
+		if (!success)
+			blog(LOG_WARNING, "[Vertical Canvas] failed to save disk backtrack to '%s'", job.path);
+
+		pthread_mutex_lock(&ring->mutex);
+		// the callback is cleared by backtrack_ring_destroy, so it never runs after its owner is gone
+		if (ring->callback)
+			ring->callback(ring->param, job.path, success, job.bytes, duration,
+				       (uint32_t)(job.window_ns / 1000000000ULL));
+		ring->pinned--;
+		if (!ring->stop)
+			backtrack_ring_prune(ring);
+		pthread_mutex_unlock(&ring->mutex);
+
+		for (size_t i = 0; i < job.segments.num; i++)
+			bfree(job.segments.array[i]);
+		da_free(job.segments);
+		bfree(job.path);
+	}
+	backtrack_ring_free(ring);
+	os_atomic_dec_long(&ring_teardowns);
+	return NULL;
+}
+
+backtrack_ring_t *backtrack_ring_create(const char *directory, uint32_t duration_sec, backtrack_saved_callback_t callback,
+					void *param)
+{
+	struct backtrack_ring *ring = bzalloc(sizeof(struct backtrack_ring));
+	ring->duration_ns = (uint64_t)duration_sec * 1000000000ULL;
+	ring->callback = callback;
+	ring->param = param;
+
+	os_mkdirs(directory);
+	// a ring that is still finishing a save in the background owns its segments until it exits
+	if (!os_atomic_load_long(&ring_teardowns))
+		backtrack_ring_remove_stale(directory);
+
+	pthread_mutex_init(&ring->mutex, NULL);
+	os_sem_init(&ring->jobs_sem, 0);
+	if (pthread_create(&ring->thread, NULL, backtrack_ring_thread, ring) == 0)
+		ring->thread_created = true;
+	return ring;
+}
+
+// does not wait for a save in progress: the worker finishes its queued copies, then frees the ring itself
+void backtrack_ring_destroy(backtrack_ring_t *ring)
+{
+	if (!ring)
+		return;
+
+	pthread_mutex_lock(&ring->mutex);
+	ring->stop = true;
+	ring->callback = NULL;
+	ring->param = NULL;
+	pthread_mutex_unlock(&ring->mutex);
+
+	if (!ring->thread_created) {
+		backtrack_ring_free(ring);
+		return;
+	}
+	os_atomic_inc_long(&ring_teardowns);
+	os_sem_post(ring->jobs_sem);
+	pthread_detach(ring->thread);
+}
+
+// aborts any background copies and waits for their workers, so no ring thread outlives the module
+void backtrack_ring_shutdown(void)
+{
+	os_atomic_set_bool(&ring_shutdown, true);
+	while (os_atomic_load_long(&ring_teardowns) > 0)
+		os_sleep_ms(10);
+}
+
+void backtrack_ring_segment_started(backtrack_ring_t *ring, const char *path)
+{
+	const uint64_t now = os_gettime_ns();
+	pthread_mutex_lock(&ring->mutex);
+	if (ring->current.path) {
+		ring->current.end_ns = now;
+		da_push_back(ring->segments, &ring->current);
+	}
+	ring->current.path = bstrdup(path);
+	ring->current.start_ns = now;
+	ring->current.end_ns = 0;
+	backtrack_ring_queue_saves(ring);
+	backtrack_ring_prune(ring);
+	pthread_mutex_unlock(&ring->mutex);
+}
+
+void backtrack_ring_request_save(backtrack_ring_t *ring, const char *path, uint32_t seconds)
+{
+	struct backtrack_save_request request;
+	request.path = bstrdup(path);
+	pthread_mutex_lock(&ring->mutex);
+	request.window_ns = ring->duration_ns;
+	if (seconds && (uint64_t)seconds * 1000000000ULL < ring->duration_ns)
+		request.window_ns = (uint64_t)seconds * 1000000000ULL;
+	da_push_back(ring->pending_saves, &request);
+	pthread_mutex_unlock(&ring->mutex);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <util/darray.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct backtrack_ring;
+typedef struct backtrack_ring backtrack_ring_t;
+
+typedef void (*backtrack_saved_callback_t)(void *param, const char *path, bool success, uint64_t bytes,
+					   uint64_t duration_ns, uint32_t seconds);
+
+backtrack_ring_t *backtrack_ring_create(const char *directory, uint32_t duration_sec, backtrack_saved_callback_t callback,
+					void *param);
+void backtrack_ring_destroy(backtrack_ring_t *ring);
+void backtrack_ring_shutdown(void);
+void backtrack_ring_segment_started(backtrack_ring_t *ring, const char *path);
+void backtrack_ring_request_save(backtrack_ring_t *ring, const char *path, uint32_t seconds);
+
+#ifdef __cplusplus
+};
+#endif
@@ -0,0 +1,67 @@
+#[=======================================================================[.rst
+FindFFmpeg
+----------
+
+Finds the FFmpeg libraries used by the background remux queue.
+
+Components: avformat, avcodec, avutil
+
+Imported Targets
+^^^^^^^^^^^^^^^^
+
+``FFmpeg::<component>``
+
+Result Variables
+^^^^^^^^^^^^^^^^
+
+``FFmpeg_FOUND``
+``FFmpeg_<component>_FOUND``
+
+#]=======================================================================]
+
+include(FindPackageHandleStandardArgs)
+
+find_package(PkgConfig QUIET)
+
+if(NOT FFmpeg_FIND_COMPONENTS)
+  set(FFmpeg_FIND_COMPONENTS avformat avcodec avutil)
+endif()
+
+foreach(component IN LISTS FFmpeg_FIND_COMPONENTS)
+  if(PKG_CONFIG_FOUND)
+    pkg_check_modules(PC_FFmpeg_${component} QUIET lib${component})
+  endif()
+
+  find_path(
+    FFmpeg_${component}_INCLUDE_DIR
+    NAMES lib${component}/${component}.h
+    HINTS ${PC_FFmpeg_${component}_INCLUDE_DIRS}
+    PATHS /usr/include /usr/local/include
+    DOC "FFmpeg ${component} include directory")
+
+  find_library(
+    FFmpeg_${component}_LIBRARY
+    NAMES ${component} lib${component}
+    HINTS ${PC_FFmpeg_${component}_LIBRARY_DIRS}
+    PATHS /usr/lib /usr/local/lib
+    DOC "FFmpeg ${component} location")
+
+  if(FFmpeg_${component}_INCLUDE_DIR AND FFmpeg_${component}_LIBRARY)
+    set(FFmpeg_${component}_FOUND TRUE)
+    if(NOT TARGET FFmpeg::${component})
+      add_library(FFmpeg::${component} UNKNOWN IMPORTED)
+      set_target_properties(
+        FFmpeg::${component}
+        PROPERTIES IMPORTED_LOCATION "${FFmpeg_${component}_LIBRARY}" INTERFACE_INCLUDE_DIRECTORIES
+                                                                      "${FFmpeg_${component}_INCLUDE_DIR}")
+    endif()
+  else()
+    set(FFmpeg_${component}_FOUND FALSE)
+  endif()
+  mark_as_advanced(FFmpeg_${component}_INCLUDE_DIR FFmpeg_${component}_LIBRARY)
+endforeach()
+
+find_package_handle_standard_args(
+  FFmpeg
+  REQUIRED_VARS FFmpeg_avformat_LIBRARY FFmpeg_avformat_INCLUDE_DIR
+  HANDLE_COMPONENTS REASON_FAILURE_MESSAGE "Install the FFmpeg development packages or set ENABLE_REMUX_QUEUE=OFF.")
@@ -20,6 +20,8 @@
 #include <QDesktopServices>
 #include <QUrl>
 
+#include <algorithm>
+
 #include "hotkey-edit.hpp"
 #include "obs-module.h"
 #include "version.h"
@@ -149,6 +151,10 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 
 	generalLayout->addRow(QString::fromUtf8(obs_module_text("Resolution")), resolution);
 
+	derivedCanvases = new QLineEdit;
+	derivedCanvases->setPlaceholderText(QString::fromUtf8("1080x1350, 1080x1080"));
+	generalLayout->addRow(QString::fromUtf8(obs_module_text("DerivedCanvases")), derivedCanvases);
+
 	audioBitrate = new QComboBox;
 	audioBitrate->addItem("64", QVariant(64));
 	audioBitrate->addItem("96", QVariant(96));
@@ -172,6 +178,13 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 
 	generalLayout->addRow(QString::fromUtf8(obs_frontend_get_locale_string("Basic.VCam.VirtualCamera")), virtualCameraMode);
 
+	scenePrewarmTtl = new QSpinBox();
+	scenePrewarmTtl->setMinimum(0);
+	scenePrewarmTtl->setMaximum(60000);
+	scenePrewarmTtl->setSingleStep(500);
+	scenePrewarmTtl->setSuffix(" ms");
+	generalLayout->addRow(QString::fromUtf8(obs_module_text("ScenePrewarmTtl")), scenePrewarmTtl);
+
 	auto backtrackGroup = new QGroupBox;
 	backtrackGroup->setStyleSheet(QString("QGroupBox{ padding-top: 4px;}"));
 	auto backtrackLayout = new QFormLayout;
@@ -224,6 +237,9 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 
 	backtrackLayout->addRow(QString::fromUtf8(obs_module_text("BacktrackPath")), backtrackPathLayout);
 
+	backtrackDisk = new QCheckBox(QString::fromUtf8(obs_module_text("BacktrackDisk")));
+	backtrackLayout->addWidget(backtrackDisk);
+
 	auto replayHotkeys = GetHotKeysFromOutput(canvasDock->replayOutput);
 
 	for (auto &hotkey : replayHotkeys) {
@@ -240,7 +256,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 	}
 
 	OBSHotkeyWidget *otherHotkey = nullptr;
-	auto hotkey = GetHotkeyByName("VerticalCanvasDockStartBacktrack");
+	auto hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "StartBacktrack");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -254,7 +270,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		hotkeys.push_back(hw);
 	}
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockStopBacktrack");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "StopBacktrack");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -271,6 +287,16 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		}
 	}
 
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "SaveDiskBacktrack");
+	if (hotkey) {
+		auto id = obs_hotkey_get_id(hotkey);
+		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
+		auto hn = obs_hotkey_get_name(hotkey);
+		auto hw = new OBSHotkeyWidget(this, id, hn, combos);
+		backtrackLayout->addRow(QString::fromUtf8(obs_module_text("SaveDiskBacktrackHotkey")), hw);
+		hotkeys.push_back(hw);
+	}
+
 	auto maxWidth = 180;
 	for (int row = 0; row < generalLayout->rowCount(); row++) {
 		auto item = generalLayout->itemAt(row, QFormLayout::LabelRole);
@@ -341,6 +367,9 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 			servers.pop_back();
 			keys.pop_back();
 			servers_enabled.pop_back();
+			servers_adaptive.pop_back();
+			servers_bitrate_floor.pop_back();
+			servers_bitrate_ceiling.pop_back();
 		});
 		hl->addWidget(removeButton);
 
@@ -358,7 +387,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 	streamingLayout->addWidget(streamingMatchMain);
 
 	otherHotkey = nullptr;
-	hotkey = GetHotkeyByName("VerticalCanvasDockStartStreaming");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "StartStreaming");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -372,7 +401,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		hotkeys.push_back(hw);
 	}
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockStopStreaming");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "StopStreaming");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -389,6 +418,19 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		}
 	}
 
+	streamStartParallel = new QSpinBox();
+	streamStartParallel->setMinimum(0);
+	streamStartParallel->setMaximum(32);
+	streamStartParallel->setSpecialValueText(QString::fromUtf8(obs_module_text("All")));
+	streamingLayout->addRow(QString::fromUtf8(obs_module_text("StreamStartParallel")), streamStartParallel);
+
+	streamStartStagger = new QSpinBox();
+	streamStartStagger->setMinimum(0);
+	streamStartStagger->setMaximum(10000);
+	streamStartStagger->setSingleStep(100);
+	streamStartStagger->setSuffix(" ms");
+	streamingLayout->addRow(QString::fromUtf8(obs_module_text("StreamStartStagger")), streamStartStagger);
+
 	streamingGroup->setLayout(streamingLayout);
 
 	auto streamingDelayGroup =
@@ -629,9 +671,16 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 	recordLayout->addRow(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Settings.Output.SplitFile.Size")),
 			     max_size_layout);
 
+	recordWriteBuffer = new QSpinBox();
+	recordWriteBuffer->setMinimum(0);
+	recordWriteBuffer->setMaximum(1024);
+	recordWriteBuffer->setSuffix(" MB");
+	recordWriteBuffer->setSpecialValueText(QString::fromUtf8(obs_frontend_get_locale_string("Default")));
+	recordLayout->addRow(QString::fromUtf8(obs_module_text("RecordWriteBuffer")), recordWriteBuffer);
+
 	otherHotkey = nullptr;
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockStartRecording");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "StartRecording");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -645,7 +694,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		hotkeys.push_back(hw);
 	}
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockStopRecording");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "StopRecording");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -665,7 +714,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 
 	otherHotkey = nullptr;
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockPause");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "Pause");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -679,7 +728,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		hotkeys.push_back(hw);
 	}
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockUnpause");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "Unpause");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -697,7 +746,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		}
 	}
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockChapter");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "Chapter");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -711,7 +760,7 @@ OBSBasicSettings::OBSBasicSettings(CanvasDock *canvas_dock, QMainWindow *parent)
 		hotkeys.push_back(hw);
 	}
 
-	hotkey = GetHotkeyByName("VerticalCanvasDockSplit");
+	hotkey = GetHotkeyByName(QString::fromUtf8(canvasDock->dock_id.c_str()) + "Split");
 	if (hotkey) {
 		auto id = obs_hotkey_get_id(hotkey);
 		std::vector<obs_key_combination_t> combos = GetCombosForHotkey(id);
@@ -1115,6 +1164,31 @@ void OBSBasicSettings::AddServer()
 	serverLayout->addRow(QString::fromUtf8(obs_module_text("Key")), subLayout);
 	keys.push_back(key);
 
+	auto adaptive = new QCheckBox(QString::fromUtf8(obs_module_text("AdaptiveBitrate")));
+	serverLayout->addRow(adaptive);
+	servers_adaptive.push_back(adaptive);
+
+	auto bitrateLayout = new QHBoxLayout;
+	auto bitrateFloor = new QSpinBox;
+	bitrateFloor->setSuffix(" Kbps");
+	bitrateFloor->setMinimum(0);
+	bitrateFloor->setMaximum(1000000);
+	bitrateFloor->setSpecialValueText(QString::fromUtf8(obs_frontend_get_locale_string("Auto")));
+	bitrateFloor->setEnabled(false);
+	auto bitrateCeiling = new QSpinBox;
+	bitrateCeiling->setSuffix(" Kbps");
+	bitrateCeiling->setMinimum(0);
+	bitrateCeiling->setMaximum(1000000);
+	bitrateCeiling->setSpecialValueText(QString::fromUtf8(obs_frontend_get_locale_string("Auto")));
+	bitrateCeiling->setEnabled(false);
+	bitrateLayout->addWidget(bitrateFloor);
+	bitrateLayout->addWidget(bitrateCeiling);
+	serverLayout->addRow(QString::fromUtf8(obs_module_text("BitrateRange")), bitrateLayout);
+	servers_bitrate_floor.push_back(bitrateFloor);
+	servers_bitrate_ceiling.push_back(bitrateCeiling);
+	connect(adaptive, &QCheckBox::toggled, bitrateFloor, &QSpinBox::setEnabled);
+	connect(adaptive, &QCheckBox::toggled, bitrateCeiling, &QSpinBox::setEnabled);
+
 	serverGroup->setLayout(serverLayout);
 	streamingLayout->insertRow(idx + 1, serverGroup);
 }
@@ -1133,12 +1207,24 @@ void OBSBasicSettings::LoadSettings()
 	}
 
 	resolution->setEnabled(enable);
+	QStringList derived;
+	for (const auto &dc : canvasDock->derivedCanvases) {
+		derived.append(QString::number(dc.width) + "x" + QString::number(dc.height));
+	}
+	derivedCanvases->setText(derived.join(", "));
+	for (const auto &dc : canvasDock->derivedCanvases) {
+		if (obs_output_active(dc.recordOutput))
+			enable = false;
+	}
+	derivedCanvases->setEnabled(enable);
 	virtualCameraMode->setCurrentIndex(canvasDock->virtual_cam_mode);
+	scenePrewarmTtl->setValue(canvasDock->scene_prewarm_ttl_ms);
 	recordVideoBitrate->setValue(canvasDock->recordVideoBitrate ? canvasDock->recordVideoBitrate : 6000);
 	maxTimeEnable->setChecked(canvasDock->max_time_sec > 0);
 	maxTime->setValue(canvasDock->max_time_sec);
 	maxSizeEnable->setChecked(canvasDock->max_size_mb > 0);
 	maxSize->setValue(canvasDock->max_size_mb);
+	recordWriteBuffer->setValue(canvasDock->record_write_buffer_mb);
 	recordingMatchMain->setChecked(canvasDock->recordingMatchMain);
 	streamingVideoBitrate->setValue(canvasDock->streamingVideoBitrate ? canvasDock->streamingVideoBitrate : 6000);
 	streamingMatchMain->setChecked(canvasDock->streamingMatchMain);
@@ -1150,6 +1236,7 @@ void OBSBasicSettings::LoadSettings()
 	backtrackClip->setChecked(canvasDock->startReplay);
 	backtrackDuration->setValue(canvasDock->replayDuration);
 	backtrackPath->setText(QString::fromUtf8(canvasDock->replayPath));
+	backtrackDisk->setChecked(canvasDock->replayDisk);
 
 	auto profile_config = obs_frontend_get_profile_config();
 	if (config_get_bool(profile_config, "Stream1", "EnableMultitrackVideo")) {
@@ -1177,6 +1264,9 @@ void OBSBasicSettings::LoadSettings()
 			key->setText(QString::fromUtf8(canvasDock->streamOutputs[idx].stream_key));
 			servers[idx]->setCurrentText(QString::fromUtf8(canvasDock->streamOutputs[idx].stream_server));
 			servers_enabled[idx]->setChecked(canvasDock->streamOutputs[idx].enabled);
+			servers_adaptive[idx]->setChecked(canvasDock->streamOutputs[idx].adaptive_bitrate);
+			servers_bitrate_floor[idx]->setValue(canvasDock->streamOutputs[idx].bitrate_floor);
+			servers_bitrate_ceiling[idx]->setValue(canvasDock->streamOutputs[idx].bitrate_ceiling);
 		}
 
 		if (servers.empty()) {
@@ -1191,6 +1281,8 @@ void OBSBasicSettings::LoadSettings()
 	streamDelayEnable->setChecked(canvasDock->stream_delay_enabled);
 	streamDelayDuration->setValue(canvasDock->stream_delay_duration);
 	streamDelayPreserve->setChecked(canvasDock->stream_delay_preserve);
+	streamStartParallel->setValue(canvasDock->stream_start_parallel);
+	streamStartStagger->setValue(canvasDock->stream_start_stagger_ms);
 
 	auto idx = streamingEncoder->findData(QVariant(QString::fromUtf8(canvasDock->stream_encoder.c_str())));
 	if (idx != -1)
@@ -1237,6 +1329,8 @@ void OBSBasicSettings::SaveSettings()
 	    (width != canvasDock->canvas_width || height != canvasDock->canvas_height)) {
 		if (obs_output_active(canvasDock->replayOutput))
 			obs_output_stop(canvasDock->replayOutput);
+		if (obs_output_active(canvasDock->diskReplayOutput))
+			obs_output_stop(canvasDock->diskReplayOutput);
 
 		blog(LOG_INFO, "[Vertical Canvas] resolution changed from %dx%d to %dx%d", canvasDock->canvas_width,
 		     canvasDock->canvas_height, width, height);
@@ -1260,17 +1354,48 @@ void OBSBasicSettings::SaveSettings()
 		canvasDock->LoadScenes();
 		canvasDock->ProfileChanged();
 	}
+	canvasDock->UpdateDerivedCanvases();
+
+	if (derivedCanvases->isEnabled()) {
+		std::vector<DerivedCanvas> derived;
+		for (const auto &part : derivedCanvases->text().split(",", Qt::SkipEmptyParts)) {
+			uint32_t dw, dh;
+			if (sscanf(part.trimmed().toUtf8().constData(), "%ux%u", &dw, &dh) != 2 || !dw || !dh)
+				continue;
+			dw += dw & 1;
+			dh += dh & 1;
+			auto it = std::find_if(canvasDock->derivedCanvases.begin(), canvasDock->derivedCanvases.end(),
+					       [dw, dh](const DerivedCanvas &dc) { return dc.width == dw && dc.height == dh; });
+			if (it != canvasDock->derivedCanvases.end()) {
+				derived.push_back(*it);
+				canvasDock->derivedCanvases.erase(it);
+				continue;
+			}
+			DerivedCanvas dc;
+			dc.width = dw;
+			dc.height = dh;
+			dc.name = std::to_string(dw) + "x" + std::to_string(dh);
+			derived.push_back(dc);
+		}
+		for (auto &dc : canvasDock->derivedCanvases)
+			canvasDock->ReleaseDerivedCanvas(dc);
+		canvasDock->derivedCanvases = derived;
+	}
+
 	if (virtualCameraMode->currentIndex() >= 0)
 		canvasDock->virtual_cam_mode = virtualCameraMode->currentIndex();
+	canvasDock->scene_prewarm_ttl_ms = scenePrewarmTtl->value();
 
 	uint32_t bitrate = (uint32_t)recordVideoBitrate->value();
 	if (bitrate != canvasDock->recordVideoBitrate) {
 		canvasDock->recordVideoBitrate = bitrate;
 		SetEncoderBitrate(obs_output_get_video_encoder(canvasDock->replayOutput), true);
+		SetEncoderBitrate(obs_output_get_video_encoder(canvasDock->diskReplayOutput), true);
 		SetEncoderBitrate(obs_output_get_video_encoder(canvasDock->recordOutput), true);
 	}
 	canvasDock->max_size_mb = maxSizeEnable->isChecked() ? maxSize->value() : 0;
 	canvasDock->max_time_sec = maxTimeEnable->isChecked() ? maxTime->value() : 0;
+	canvasDock->record_write_buffer_mb = recordWriteBuffer->value();
 	canvasDock->recordingMatchMain = recordingMatchMain->isChecked();
 	bitrate = (uint32_t)streamingVideoBitrate->value();
 	if (bitrate != canvasDock->streamingVideoBitrate) {
@@ -1293,13 +1418,15 @@ void OBSBasicSettings::SaveSettings()
 	auto startReplay = backtrackClip->isChecked();
 	auto duration = (uint32_t)backtrackDuration->value();
 	std::string replayPath = backtrackPath->text().toUtf8().constData();
+	auto replayDisk = backtrackDisk->isChecked();
 	if (duration != canvasDock->replayDuration || replayPath != canvasDock->replayPath ||
-	    canvasDock->startReplay != startReplay) {
+	    canvasDock->startReplay != startReplay || canvasDock->replayDisk != replayDisk) {
 		canvasDock->replayDuration = duration;
 		canvasDock->replayPath = replayPath;
 		canvasDock->startReplay = startReplay;
+		canvasDock->replayDisk = replayDisk;
 		if (canvasDock->replayAlwaysOn || startReplay) {
-			if (obs_output_active(canvasDock->replayOutput)) {
+			if (canvasDock->BacktrackActive()) {
 				canvasDock->StopReplayBuffer();
 				QTimer::singleShot(500, this, [this] { canvasDock->CheckReplayBuffer(true); });
 			} else {
@@ -1310,6 +1437,7 @@ void OBSBasicSettings::SaveSettings()
 		}
 	}
 	if (!canvasDock->disable_stream_settings) {
+		canvasDock->DisarmStream();
 		for (size_t idx = 0; idx < servers.size(); idx++) {
 			std::string sk = keys[idx]->text().toUtf8().constData();
 			std::string ss = servers[idx]->currentText().toUtf8().constData();
@@ -1335,6 +1463,9 @@ void OBSBasicSettings::SaveSettings()
 				}
 			}
 			canvasDock->streamOutputs[idx].enabled = servers_enabled[idx]->isChecked();
+			canvasDock->streamOutputs[idx].adaptive_bitrate = servers_adaptive[idx]->isChecked();
+			canvasDock->streamOutputs[idx].bitrate_floor = servers_bitrate_floor[idx]->value();
+			canvasDock->streamOutputs[idx].bitrate_ceiling = servers_bitrate_ceiling[idx]->value();
 		}
 
 		if (canvasDock->streamOutputs.size() > servers.size()) {
@@ -1362,6 +1493,8 @@ void OBSBasicSettings::SaveSettings()
 					     canvasDock->stream_delay_preserve ? OBS_OUTPUT_DELAY_PRESERVE : 0);
 		}
 	}
+	canvasDock->stream_start_parallel = streamStartParallel->value();
+	canvasDock->stream_start_stagger_ms = streamStartStagger->value();
 
 	auto sa = !streamingUseMain->isChecked();
 	auto se = streamingEncoder->currentData().toString().toUtf8();
@@ -1416,6 +1549,8 @@ void OBSBasicSettings::SaveSettings()
 				obs_output_set_video_encoder(canvasDock->recordOutput, nullptr);
 			if (canvasDock->replayOutput)
 				obs_output_set_video_encoder(canvasDock->replayOutput, nullptr);
+			if (canvasDock->diskReplayOutput && !obs_output_active(canvasDock->diskReplayOutput))
+				obs_output_set_video_encoder(canvasDock->diskReplayOutput, nullptr);
 			if (enc && strcmp(obs_encoder_get_name(enc), "vertical_canvas_record_video_encoder") == 0) {
 				obs_encoder_release(enc);
 			}
@@ -1445,6 +1580,8 @@ void OBSBasicSettings::SaveSettings()
 					obs_output_set_audio_encoder(canvasDock->recordOutput, nullptr, i);
 				if (canvasDock->replayOutput)
 					obs_output_set_audio_encoder(canvasDock->replayOutput, nullptr, i);
+				if (canvasDock->diskReplayOutput && !obs_output_active(canvasDock->diskReplayOutput))
+					obs_output_set_audio_encoder(canvasDock->diskReplayOutput, nullptr, i);
 				obs_encoder_release(enc);
 			}
 		}
@@ -32,19 +32,23 @@ private:
 	QLabel *newVersion;
 	QListWidget *listWidget;
 	QComboBox *resolution;
+	QLineEdit *derivedCanvases;
 	QSpinBox *streamingVideoBitrate;
 	QCheckBox *streamingMatchMain;
 	QSpinBox *recordVideoBitrate;
 	QCheckBox *recordingMatchMain;
 	QComboBox *audioBitrate;
 	QComboBox *virtualCameraMode;
+	QSpinBox *scenePrewarmTtl;
 	QCheckBox *backtrackClip;
 	QSpinBox *backtrackDuration;
 	QLineEdit *backtrackPath;
+	QCheckBox *backtrackDisk;
 	QCheckBox *maxSizeEnable;
 	QSpinBox *maxSize;
 	QCheckBox *maxTimeEnable;
 	QSpinBox *maxTime;
+	QSpinBox *recordWriteBuffer;
 	QLabel *multitrackLabel;
 
 	QFormLayout *streamingLayout;
@@ -52,10 +56,15 @@ private:
 	std::vector<QComboBox *> servers;
 	std::vector<QLineEdit *> keys;
 	std::vector<QCheckBox *> servers_enabled;
+	std::vector<QCheckBox *> servers_adaptive;
+	std::vector<QSpinBox *> servers_bitrate_floor;
+	std::vector<QSpinBox *> servers_bitrate_ceiling;
 
 	QCheckBox *streamDelayEnable;
 	QSpinBox *streamDelayDuration;
 	QCheckBox *streamDelayPreserve;
+	QSpinBox *streamStartParallel;
+	QSpinBox *streamStartStagger;
 
 	QCheckBox *streamingUseMain;
 	std::vector<QRadioButton *> streamingAudioTracks;
@@ -0,0 +1,213 @@
+#include <obs-module.h>
+#include <util/profiler.h>
+#include "derived-canvas-source.h"
+
+struct derived_canvas_parent {
+	obs_canvas_t *canvas;
+	uint32_t width;
+	uint32_t height;
+	gs_texrender_t *render;
+	uint64_t frame_time;
+	long refs;
+};
+
+struct derived_canvas_info {
+	obs_source_t *source;
+	struct derived_canvas_parent *parent;
+	uint32_t width;
+	uint32_t height;
+	uint32_t crop_x;
+	uint32_t crop_y;
+	uint32_t crop_cx;
+	uint32_t crop_cy;
+};
+
+// shared per parent canvas so every derived canvas of one parent costs a single composite render per frame
+static DARRAY(struct derived_canvas_parent *) derived_parents;
+
+const char *derived_canvas_get_name(void *type_data)
+{
+	UNUSED_PARAMETER(type_data);
+	return "vertical_derived_canvas";
+}
+
+static void derived_canvas_update_crop(struct derived_canvas_info *dc)
+{
+	dc->crop_x = 0;
+	dc->crop_y = 0;
+	dc->crop_cx = 0;
+	dc->crop_cy = 0;
+	if (!dc->parent || !dc->width || !dc->height || !dc->parent->width || !dc->parent->height)
+		return;
+
+	const uint32_t pw = dc->parent->width;
+	const uint32_t ph = dc->parent->height;
+	if ((uint64_t)pw * dc->height > (uint64_t)ph * dc->width) {
+		dc->crop_cy = ph;
+		dc->crop_cx = (uint32_t)((uint64_t)ph * dc->width / dc->height);
+		dc->crop_x = (pw - dc->crop_cx) / 2;
+	} else {
+		dc->crop_cx = pw;
+		dc->crop_cy = (uint32_t)((uint64_t)pw * dc->height / dc->width);
+		dc->crop_y = (ph - dc->crop_cy) / 2;
+	}
+}
+
+static void derived_canvas_release_parent(struct derived_canvas_info *dc)
+{
+	struct derived_canvas_parent *p = dc->parent;
+	dc->parent = NULL;
+	if (!p || --p->refs > 0)
+		return;
+	da_erase_item(derived_parents, &p);
+	gs_texrender_destroy(p->render);
+	bfree(p);
+	if (!derived_parents.num)
+		da_free(derived_parents);
+}
+
+void *derived_canvas_create(obs_data_t *settings, obs_source_t *source)
+{
+	struct derived_canvas_info *dc = bzalloc(sizeof(struct derived_canvas_info));
+	dc->source = source;
+	dc->width = (uint32_t)obs_data_get_int(settings, "width");
+	dc->height = (uint32_t)obs_data_get_int(settings, "height");
+	return dc;
+}
+
+void derived_canvas_destroy(void *data)
+{
+	struct derived_canvas_info *dc = data;
+	obs_enter_graphics();
+	derived_canvas_release_parent(dc);
+	obs_leave_graphics();
+	bfree(data);
+}
+
+void derived_canvas_update(void *data, obs_data_t *settings)
+{
+	struct derived_canvas_info *dc = data;
+	obs_enter_graphics();
+	dc->width = (uint32_t)obs_data_get_int(settings, "width");
+	dc->height = (uint32_t)obs_data_get_int(settings, "height");
+	derived_canvas_update_crop(dc);
+	obs_leave_graphics();
+}
+
+static void derived_canvas_render_parent(struct derived_canvas_parent *p)
+{
+	const uint64_t frame_time = obs_get_video_frame_time();
+	if (p->frame_time == frame_time && gs_texrender_get_texture(p->render))
+		return;
+	p->frame_time = frame_time;
+
+	const enum gs_color_format format = gs_get_format_from_space(gs_get_color_space());
+	if (gs_texrender_get_format(p->render) != format) {
+		gs_texrender_destroy(p->render);
+		p->render = gs_texrender_create(format, GS_ZS_NONE);
+	}
+
+	gs_texrender_reset(p->render);
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+	if (gs_texrender_begin_with_color_space(p->render, p->width, p->height, gs_get_color_space())) {
+		struct vec4 clear_color;
+
+		vec4_zero(&clear_color);
+		gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+		gs_ortho(0.0f, (float)p->width, 0.0f, (float)p->height, -100.0f, 100.0f);
+
+		obs_canvas_render(p->canvas);
+
+		gs_texrender_end(p->render);
+	}
+	gs_blend_state_pop();
+}
+
+static const char *derived_canvas_render_name = "derived_canvas_video_render";
+
+static void derived_canvas_video_render(void *data, gs_effect_t *effect)
+{
+	struct derived_canvas_info *dc = data;
+	if (!dc->parent || !dc->crop_cx || !dc->crop_cy)
+		return;
+
+	profile_start(derived_canvas_render_name);
+	derived_canvas_render_parent(dc->parent);
+
+	gs_texture_t *tex = gs_texrender_get_texture(dc->parent->render);
+	if (!tex) {
+		profile_end(derived_canvas_render_name);
+		return;
+	}
+
+	effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+
+	const bool previous = gs_framebuffer_srgb_enabled();
+	gs_enable_framebuffer_srgb(true);
+
+	gs_effect_set_texture_srgb(gs_effect_get_param_by_name(effect, "image"), tex);
+
+	gs_matrix_push();
+	gs_matrix_scale3f((float)dc->width / (float)dc->crop_cx, (float)dc->height / (float)dc->crop_cy, 1.0f);
+	while (gs_effect_loop(effect, "Draw"))
+		gs_draw_sprite_subregion(tex, 0, dc->crop_x, dc->crop_y, dc->crop_cx, dc->crop_cy);
+	gs_matrix_pop();
+
+	gs_enable_framebuffer_srgb(previous);
+	profile_end(derived_canvas_render_name);
+}
+
+uint32_t derived_canvas_get_width(void *data)
+{
+	struct derived_canvas_info *dc = data;
+	return dc->width;
+}
+
+uint32_t derived_canvas_get_height(void *data)
+{
+	struct derived_canvas_info *dc = data;
+	return dc->height;
+}
+
+void derived_canvas_source_set_parent(void *data, obs_canvas_t *canvas, uint32_t width, uint32_t height)
+{
+	struct derived_canvas_info *dc = data;
+	obs_enter_graphics();
+	derived_canvas_release_parent(dc);
+	if (canvas && width && height) {
+		struct derived_canvas_parent *p = NULL;
+		for (size_t i = 0; i < derived_parents.num; i++) {
+			struct derived_canvas_parent *e = derived_parents.array[i];
+			if (e->canvas == canvas && e->width == width && e->height == height) {
+				p = e;
+				break;
+			}
+		}
+		if (!p) {
+			p = bzalloc(sizeof(struct derived_canvas_parent));
+			p->canvas = canvas;
+			p->width = width;
+			p->height = height;
+			p->render = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+			da_push_back(derived_parents, &p);
+		}
+		p->refs++;
+		dc->parent = p;
+	}
+	derived_canvas_update_crop(dc);
+	obs_leave_graphics();
+}
+
+struct obs_source_info derived_canvas_source = {
+	.id = "vertical_derived_canvas_source",
+	.type = OBS_SOURCE_TYPE_INPUT,
+	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_CAP_DISABLED | OBS_SOURCE_CUSTOM_DRAW,
+	.get_name = derived_canvas_get_name,
+	.create = derived_canvas_create,
+	.destroy = derived_canvas_destroy,
+	.update = derived_canvas_update,
+	.video_render = derived_canvas_video_render,
+	.get_width = derived_canvas_get_width,
+	.get_height = derived_canvas_get_height,
+};
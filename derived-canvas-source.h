@@ -0,0 +1,15 @@
+#pragma once
+
+#include <util/darray.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void derived_canvas_source_set_parent(void *data, obs_canvas_t *canvas, uint32_t width, uint32_t height);
+
+extern struct obs_source_info derived_canvas_source;
+
+#ifdef __cplusplus
+};
+#endif
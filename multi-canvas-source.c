@@ -1,5 +1,6 @@
 
 #include <obs-module.h>
+#include <util/profiler.h>
 #include "multi-canvas-source.h"
 
 struct multi_canvas_info {
@@ -55,9 +56,12 @@ bool view_get_height(void *data, struct obs_video_info *ovi)
 	return true;
 }
 
+static const char *multi_canvas_render_name = "multi_canvas_video_render";
+
 static void multi_canvas_video_render(void *data, gs_effect_t *effect)
 {
 	struct multi_canvas_info *mc = data;
+	profile_start(multi_canvas_render_name);
 	gs_matrix_push();
 	for (uint32_t i = 0; i < MAX_CHANNELS; i++) {
 		obs_source_t *s = obs_get_output_source(i);
@@ -123,6 +127,7 @@ static void multi_canvas_video_render(void *data, gs_effect_t *effect)
 		gs_matrix_translate3f((float)mc->widths.array[i], 0.0f, 0.0f);
 	}
 	gs_matrix_pop();
+	profile_end(multi_canvas_render_name);
 }
 
 uint32_t multi_canvas_get_width(void *data)
@@ -0,0 +1,6 @@
+#pragma once
+
+enum class ProjectorType {
+	Preview,
+	Multiview,
+};
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <QAction>
 #include <QGuiApplication>
 #include <QMouseEvent>
@@ -9,10 +10,14 @@
 #include <obs-frontend-api.h>
 #include <util/config-file.h>
 #include <util/platform.h>
+#include <util/profiler.h>
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+#define MULTIVIEW_MAX_SCENES 24
+#define MULTIVIEW_MIN_BUDGET_NS 250000ULL
+
 static inline void GetScaleAndCenterPos(int baseCX, int baseCY, int windowCX, int windowCY, int &x, int &y, float &scale)
 {
 	double windowAspect, baseAspect;
@@ -49,9 +54,24 @@ static inline void endRegion()
 	gs_projection_pop();
 }
 
+struct multiview_cell {
+	int x, y, cx, cy;
+};
+
+static inline multiview_cell FitCell(int areaX, int areaY, int areaCX, int areaCY, uint32_t baseCX, uint32_t baseCY)
+{
+	int x, y;
+	float scale;
+	GetScaleAndCenterPos(baseCX, baseCY, areaCX, areaCY, x, y, scale);
+	return {areaX + x, areaY + y, int(scale * float(baseCX)), int(scale * float(baseCY))};
+}
+
 config_t *get_user_config(void);
 
-OBSProjector::OBSProjector(CanvasDock *canvas_, int monitor) : OBSQTDisplay(nullptr, Qt::Window), canvas(canvas_)
+OBSProjector::OBSProjector(CanvasDock *canvas_, int monitor, ProjectorType type_)
+	: OBSQTDisplay(nullptr, Qt::Window),
+	  canvas(canvas_),
+	  type(type_)
 {
 	isAlwaysOnTop = config_get_bool(get_user_config(), "BasicWindow", "ProjectorAlwaysOnTop");
 
@@ -98,6 +118,16 @@ OBSProjector::OBSProjector(CanvasDock *canvas_, int monitor) : OBSQTDisplay(null
 	};
 
 	connect(this, &OBSQTDisplay::DisplayCreated, addDrawCallback);
+
+	if (type == ProjectorType::Multiview) {
+		auto model = canvas->sceneModel;
+		connect(model, &QAbstractItemModel::rowsInserted, this, &OBSProjector::UpdateMultiview);
+		connect(model, &QAbstractItemModel::rowsRemoved, this, &OBSProjector::UpdateMultiview);
+		connect(model, &QAbstractItemModel::rowsMoved, this, &OBSProjector::UpdateMultiview);
+		connect(model, &QAbstractItemModel::modelReset, this, &OBSProjector::UpdateMultiview);
+		connect(model, &QAbstractItemModel::layoutChanged, this, &OBSProjector::UpdateMultiview);
+		UpdateMultiview();
+	}
 	//connect(App(), &QGuiApplication::screenRemoved, this,	&OBSProjector::ScreenRemoved);
 
 	//App()->IncrementSleepInhibition();
@@ -114,6 +144,17 @@ OBSProjector::~OBSProjector()
 {
 	obs_display_remove_draw_callback(GetDisplay(), OBSRender, this);
 
+	for (auto &scene : multiviewShowing)
+		obs_source_dec_showing(scene);
+	multiviewShowing.clear();
+
+	if (!multiviewTiles.empty()) {
+		obs_enter_graphics();
+		for (auto &tile : multiviewTiles)
+			gs_texrender_destroy(tile.texrender);
+		obs_leave_graphics();
+	}
+
 	//App()->DecrementSleepInhibition();
 
 	screen = nullptr;
@@ -146,6 +187,8 @@ void OBSProjector::SetHideCursor()
 		setCursor(Qt::ArrowCursor);
 }
 
+static const char *projector_render_name = "vertical_canvas_projector_render";
+
 void OBSProjector::OBSRender(void *data, uint32_t cx, uint32_t cy)
 {
 	OBSProjector *window = reinterpret_cast<OBSProjector *>(data);
@@ -153,6 +196,14 @@ void OBSProjector::OBSRender(void *data, uint32_t cx, uint32_t cy)
 	if (!window->ready)
 		return;
 
+	profile_start(projector_render_name);
+
+	if (window->type == ProjectorType::Multiview) {
+		window->RenderMultiview(cx, cy);
+		profile_end(projector_render_name);
+		return;
+	}
+
 	obs_canvas_t *canvas = window->canvas->canvas;
 
 	uint32_t targetCX;
@@ -174,6 +225,194 @@ void OBSProjector::OBSRender(void *data, uint32_t cx, uint32_t cy)
 	obs_canvas_render(canvas);
 
 	endRegion();
+
+	profile_end(projector_render_name);
+}
+
+void OBSProjector::UpdateMultiview()
+{
+	if (type != ProjectorType::Multiview)
+		return;
+
+	std::vector<OBSWeakSource> scenes;
+	std::vector<OBSSource> showing;
+	auto model = canvas->sceneModel;
+	const int count = model->rowCount();
+	for (int i = 0; i < count && scenes.size() < MULTIVIEW_MAX_SCENES; i++) {
+		OBSSource scene = model->Source(i);
+		if (!scene)
+			continue;
+		OBSDataAutoRelease private_settings = obs_source_get_private_settings(scene);
+		obs_data_set_default_bool(private_settings, "show_in_multiview", true);
+		if (!obs_data_get_bool(private_settings, "show_in_multiview"))
+			continue;
+		scenes.push_back(OBSGetWeakRef(scene));
+		showing.push_back(scene);
+	}
+
+	/* tiles render their scene, so it has to be showing for as long as it is in the view */
+	for (auto &scene : showing)
+		if (std::find(multiviewShowing.begin(), multiviewShowing.end(), scene) == multiviewShowing.end())
+			obs_source_inc_showing(scene);
+	for (auto &scene : multiviewShowing)
+		if (std::find(showing.begin(), showing.end(), scene) == showing.end())
+			obs_source_dec_showing(scene);
+	multiviewShowing.swap(showing);
+
+	std::lock_guard<std::mutex> lock(multiviewMutex);
+	multiviewScenes.swap(scenes);
+	multiviewDirty = true;
+}
+
+// tile 0 is the preview, the rest follow the scene list and keep their texrender when they stay in the view
+void OBSProjector::SyncMultiviewTiles()
+{
+	std::vector<OBSWeakSource> scenes;
+	{
+		std::lock_guard<std::mutex> lock(multiviewMutex);
+		if (!multiviewDirty && !multiviewTiles.empty())
+			return;
+		scenes = multiviewScenes;
+		multiviewDirty = false;
+	}
+
+	std::vector<MultiviewTile> tiles(scenes.size() + 1);
+	if (!multiviewTiles.empty()) {
+		tiles[0] = multiviewTiles[0];
+		multiviewTiles[0].texrender = nullptr;
+	}
+	for (size_t i = 0; i < scenes.size(); i++) {
+		tiles[i + 1].source = scenes[i];
+		for (size_t j = 1; j < multiviewTiles.size(); j++) {
+			auto &old = multiviewTiles[j];
+			if (old.texrender && old.source.Get() == scenes[i].Get()) {
+				tiles[i + 1].texrender = old.texrender;
+				tiles[i + 1].rendered = old.rendered;
+				old.texrender = nullptr;
+				break;
+			}
+		}
+	}
+	for (auto &old : multiviewTiles)
+		gs_texrender_destroy(old.texrender);
+	multiviewTiles.swap(tiles);
+	if (multiviewNext >= multiviewTiles.size())
+		multiviewNext = 0;
+}
+
+void OBSProjector::RenderMultiviewTile(MultiviewTile &tile, obs_source_t *source, uint32_t cx, uint32_t cy)
+{
+	if (!source || !cx || !cy)
+		return;
+	if (!tile.texrender)
+		tile.texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+
+	gs_texrender_reset(tile.texrender);
+	if (!gs_texrender_begin(tile.texrender, cx, cy))
+		return;
+
+	vec4 clear_color;
+	vec4_zero(&clear_color);
+	gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+	gs_ortho(0.0f, float(canvas->canvas_width), 0.0f, float(canvas->canvas_height), -100.0f, 100.0f);
+
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+	obs_source_video_render(source);
+	gs_blend_state_pop();
+
+	gs_texrender_end(tile.texrender);
+	tile.rendered = true;
+}
+
+static void DrawMultiviewTexture(gs_texture_t *tex, const multiview_cell &cell)
+{
+	if (!tex || cell.cx <= 0 || cell.cy <= 0)
+		return;
+
+	startRegion(cell.x, cell.y, cell.cx, cell.cy, 0.0f, float(cell.cx), 0.0f, float(cell.cy));
+
+	gs_effect_t *effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+	gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), tex);
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+	while (gs_effect_loop(effect, "Draw"))
+		gs_draw_sprite(tex, 0, (uint32_t)cell.cx, (uint32_t)cell.cy);
+	gs_blend_state_pop();
+
+	endRegion();
+}
+
+/* The program is rendered live every frame. Preview and scene tiles are cached in texrenders and refreshed
+ * round-robin, spending about as much render submission time as the program itself took, so the whole multiview
+ * costs close to one extra scene render per frame no matter how many tiles it shows. */
+void OBSProjector::RenderMultiview(uint32_t cx, uint32_t cy)
+{
+	const uint32_t baseCX = canvas->canvas_width;
+	const uint32_t baseCY = canvas->canvas_height;
+	if (!baseCX || !baseCY || !cx || !cy)
+		return;
+
+	SyncMultiviewTiles();
+
+	const int sceneCount = (int)multiviewTiles.size() - 1;
+	const int topCY = sceneCount > 0 ? int(cy) / 2 : int(cy);
+	const multiview_cell previewCell = FitCell(0, 0, int(cx) / 2, topCY, baseCX, baseCY);
+	const multiview_cell programCell = FitCell(int(cx) / 2, 0, int(cx) - int(cx) / 2, topCY, baseCX, baseCY);
+
+	int columns = 1;
+	float bestScale = 0.0f;
+	for (int c = 1; c <= sceneCount; c++) {
+		const int rows = (sceneCount + c - 1) / c;
+		const float scale = std::min(float(int(cx) / c) / float(baseCX), float((int(cy) - topCY) / rows) / float(baseCY));
+		if (scale > bestScale) {
+			bestScale = scale;
+			columns = c;
+		}
+	}
+	const int cellCX = int(cx) / columns;
+	const int cellCY = sceneCount > 0 ? (int(cy) - topCY) / ((sceneCount + columns - 1) / columns) : 0;
+	const multiview_cell sceneSize = FitCell(0, 0, cellCX, cellCY, baseCX, baseCY);
+
+	uint64_t start = os_gettime_ns();
+	startRegion(programCell.x, programCell.y, programCell.cx, programCell.cy, 0.0f, float(baseCX), 0.0f, float(baseCY));
+	obs_canvas_render(canvas->canvas);
+	endRegion();
+	const uint64_t programCost = os_gettime_ns() - start;
+	programRenderNs = programRenderNs ? (programRenderNs * 7 + programCost) / 8 : programCost;
+
+	OBSSourceAutoRelease previewSource = obs_source_get_ref(obs_scene_get_source(canvas->scene));
+
+	start = os_gettime_ns();
+	const uint64_t budget = std::max<uint64_t>(programRenderNs, MULTIVIEW_MIN_BUDGET_NS);
+	if (previewSource && previewSource.Get() != multiviewPreview) {
+		multiviewPreview = previewSource.Get();
+		RenderMultiviewTile(multiviewTiles[0], previewSource, (uint32_t)previewCell.cx, (uint32_t)previewCell.cy);
+	}
+	for (size_t refreshed = 0; refreshed < multiviewTiles.size(); refreshed++) {
+		if (refreshed && os_gettime_ns() - start >= budget)
+			break;
+		const size_t idx = multiviewNext;
+		multiviewNext = (multiviewNext + 1) % multiviewTiles.size();
+		if (idx == 0) {
+			RenderMultiviewTile(multiviewTiles[0], previewSource, (uint32_t)previewCell.cx, (uint32_t)previewCell.cy);
+			continue;
+		}
+		OBSSource scene = OBSGetStrongRef(multiviewTiles[idx].source);
+		RenderMultiviewTile(multiviewTiles[idx], scene, (uint32_t)sceneSize.cx, (uint32_t)sceneSize.cy);
+	}
+
+	for (size_t i = 0; i < multiviewTiles.size(); i++) {
+		auto &tile = multiviewTiles[i];
+		if (!tile.rendered)
+			continue;
+		multiview_cell cell = previewCell;
+		if (i > 0) {
+			const int idx = int(i) - 1;
+			cell = FitCell((idx % columns) * cellCX, topCY + (idx / columns) * cellCY, cellCX, cellCY, baseCX, baseCY);
+		}
+		DrawMultiviewTexture(gs_texrender_get_texture(tile.texrender), cell);
+	}
 }
 
 void OBSProjector::mousePressEvent(QMouseEvent *event)
@@ -191,7 +430,7 @@ void OBSProjector::mousePressEvent(QMouseEvent *event)
 			popup.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Windowed")), this,
 					SLOT(OpenWindowedProjector()));
 
-		} else if (!this->isMaximized()) {
+		} else if (!this->isMaximized() && type != ProjectorType::Multiview) {
 			popup.addAction(QString::fromUtf8(obs_frontend_get_locale_string("ResizeProjectorWindowToContent")), this,
 					SLOT(ResizeToContent()));
 		}
@@ -220,7 +459,10 @@ void OBSProjector::UpdateProjectorTitle(QString name)
 	UNUSED_PARAMETER(name);
 	bool window = (GetMonitor() == -1);
 
-	QString title = QString::fromUtf8(obs_frontend_get_locale_string(window ? "PreviewWindow" : "PreviewProjector"));
+	const char *title_key = window ? "PreviewWindow" : "PreviewProjector";
+	if (type == ProjectorType::Multiview)
+		title_key = window ? "MultiviewWindowed" : "MultiviewProjector";
+	QString title = QString::fromUtf8(obs_frontend_get_locale_string(title_key));
 
 	setWindowTitle(title);
 }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <mutex>
+#include <vector>
 #include <obs.hpp>
+#include "projector-type.hpp"
 #include "qt-display.hpp"
 #include "vertical-canvas.hpp"
 
@@ -12,8 +15,27 @@ class OBSProjector : public OBSQTDisplay {
 
 private:
 	CanvasDock *canvas = nullptr;
+	ProjectorType type = ProjectorType::Preview;
+
+	struct MultiviewTile {
+		OBSWeakSource source;
+		gs_texrender_t *texrender = nullptr;
+		bool rendered = false;
+	};
+
+	std::mutex multiviewMutex;
+	std::vector<OBSWeakSource> multiviewScenes;
+	std::vector<OBSSource> multiviewShowing;
+	bool multiviewDirty = false;
+	std::vector<MultiviewTile> multiviewTiles;
+	obs_source_t *multiviewPreview = nullptr;
+	size_t multiviewNext = 0;
+	uint64_t programRenderNs = 0;
 
 	static void OBSRender(void *data, uint32_t cx, uint32_t cy);
+	void RenderMultiview(uint32_t cx, uint32_t cy);
+	void SyncMultiviewTiles();
+	void RenderMultiviewTile(MultiviewTile &tile, obs_source_t *source, uint32_t cx, uint32_t cy);
 
 	void mousePressEvent(QMouseEvent *event) override;
 	void closeEvent(QCloseEvent *event) override;
@@ -40,9 +62,11 @@ private slots:
 	void ScreenRemoved(QScreen *screen_);
 
 public:
-	OBSProjector(CanvasDock *canvas_, int monitor);
+	OBSProjector(CanvasDock *canvas_, int monitor, ProjectorType type_ = ProjectorType::Preview);
 	~OBSProjector();
 
+	void UpdateMultiview();
+
 	int GetMonitor();
 	void RenameProjector(QString oldName, QString newName);
 	void SetHideCursor();
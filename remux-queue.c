@@ -0,0 +1,313 @@
+#include <obs-module.h>
+#include <util/threading.h>
+#include <util/platform.h>
+#include <util/dstr.h>
+#include <libavformat/avformat.h>
+#include "remux-queue.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/resource.h>
+#else
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define REMUX_IO_BUFFER_SIZE (256 * 1024)
+
+#ifdef __linux__
+#define REMUX_IOPRIO_CLASS_SHIFT 13
+#define REMUX_IOPRIO_CLASS_IDLE 3
+#define REMUX_IOPRIO_WHO_PROCESS 1
+#endif
+
+struct remux_job {
+	char *path;
+	char *output;
+	remux_progress_callback_t progress;
+	remux_finished_callback_t finished;
+	void *param;
+};
+
+struct remux_io {
+	FILE *file;
+	int64_t size;
+};
+
+static pthread_mutex_t remux_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DARRAY(struct remux_job) remux_jobs;
+static void *remux_active_param = NULL;
+static os_sem_t *remux_sem = NULL;
+static pthread_t remux_thread;
+static bool remux_thread_created = false;
+static volatile bool remux_stop = false;
+
+static void remux_job_free(struct remux_job *job)
+{
+	bfree(job->path);
+	bfree(job->output);
+}
+
+// remuxing runs behind the live outputs, so the thread gives up cpu and disk priority where the platform allows it
+static void remux_lower_priority(void)
+{
+#ifdef _WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__APPLE__)
+	setiopolicy_np(IOPOL_TYPE_DISK, IOPOL_SCOPE_THREAD, IOPOL_THROTTLE);
+#else
+	const id_t tid = (id_t)syscall(SYS_gettid);
+	setpriority(PRIO_PROCESS, tid, 19);
+#ifdef __linux__
+	// idle io class: the thread only gets disk time when no other process is waiting on the device
+	if (syscall(SYS_ioprio_set, REMUX_IOPRIO_WHO_PROCESS, (int)tid, REMUX_IOPRIO_CLASS_IDLE << REMUX_IOPRIO_CLASS_SHIFT) != 0)
+		blog(LOG_WARNING, "[Vertical Canvas] failed to set idle io priority for remux thread");
+#endif
+#endif
+}
+
+static int remux_io_read(void *opaque, uint8_t *buf, int size)
+{
+	struct remux_io *io = opaque;
+	const size_t read = fread(buf, 1, (size_t)size, io->file);
+	if (!read)
+		return ferror(io->file) ? AVERROR(EIO) : AVERROR_EOF;
+	return (int)read;
+}
+
+#if LIBAVFORMAT_VERSION_MAJOR >= 61
+static int remux_io_write(void *opaque, const uint8_t *buf, int size)
+#else
+static int remux_io_write(void *opaque, uint8_t *buf, int size)
+#endif
+{
+	struct remux_io *io = opaque;
+	if (fwrite(buf, 1, (size_t)size, io->file) != (size_t)size)
+		return AVERROR(EIO);
+	return size;
+}
+
+static int64_t remux_io_seek(void *opaque, int64_t offset, int whence)
+{
+	struct remux_io *io = opaque;
+	if (whence == AVSEEK_SIZE)
+		return io->size >= 0 ? io->size : AVERROR(ENOSYS);
+	if (os_fseeki64(io->file, offset, whence & ~AVSEEK_FORCE) != 0)
+		return AVERROR(EIO);
+	return os_ftelli64(io->file);
+}
+
+static bool remux_file(struct remux_job *job)
+{
+	struct remux_io in_io = {0};
+	struct remux_io out_io = {0};
+	AVFormatContext *ic = NULL;
+	AVFormatContext *oc = NULL;
+	AVIOContext *in_pb = NULL;
+	int *stream_map = NULL;
+	AVPacket *pkt = NULL;
+	bool success = false;
+	int last_percent = -1;
+
+	in_io.file = os_fopen(job->path, "rb");
+	if (!in_io.file)
+		return false;
+	in_io.size = os_get_file_size(job->path);
+
+	in_pb = avio_alloc_context(av_malloc(REMUX_IO_BUFFER_SIZE), REMUX_IO_BUFFER_SIZE, 0, &in_io, remux_io_read, NULL,
+				   remux_io_seek);
+	ic = avformat_alloc_context();
+	ic->pb = in_pb;
+	if (avformat_open_input(&ic, NULL, NULL, NULL) < 0 || avformat_find_stream_info(ic, NULL) < 0)
+		goto cleanup;
+
+	if (avformat_alloc_output_context2(&oc, NULL, NULL, job->output) < 0)
+		goto cleanup;
+
+	stream_map = bzalloc(sizeof(int) * ic->nb_streams);
+	int out_index = 0;
+	for (unsigned int i = 0; i < ic->nb_streams; i++) {
+		AVCodecParameters *par = ic->streams[i]->codecpar;
+		if (par->codec_type != AVMEDIA_TYPE_VIDEO && par->codec_type != AVMEDIA_TYPE_AUDIO) {
+			stream_map[i] = -1;
+			continue;
+		}
+		AVStream *out = avformat_new_stream(oc, NULL);
+		if (!out || avcodec_parameters_copy(out->codecpar, par) < 0)
+			goto cleanup;
+		out->codecpar->codec_tag = 0;
+		out->time_base = ic->streams[i]->time_base;
+		stream_map[i] = out_index++;
+	}
+
+	out_io.file = os_fopen(job->output, "wb");
+	if (!out_io.file)
+		goto cleanup;
+	out_io.size = -1;
+	oc->pb = avio_alloc_context(av_malloc(REMUX_IO_BUFFER_SIZE), REMUX_IO_BUFFER_SIZE, 1, &out_io, NULL, remux_io_write,
+				    remux_io_seek);
+	if (avformat_write_header(oc, NULL) < 0)
+		goto cleanup;
+
+	pkt = av_packet_alloc();
+	int ret;
+	while ((ret = av_read_frame(ic, pkt)) >= 0) {
+		if (os_atomic_load_bool(&remux_stop)) {
+			av_packet_unref(pkt);
+			goto cleanup;
+		}
+		if (pkt->stream_index >= (int)ic->nb_streams || stream_map[pkt->stream_index] < 0) {
+			av_packet_unref(pkt);
+			continue;
+		}
+		AVStream *in_stream = ic->streams[pkt->stream_index];
+		pkt->stream_index = stream_map[pkt->stream_index];
+		av_packet_rescale_ts(pkt, in_stream->time_base, oc->streams[pkt->stream_index]->time_base);
+		pkt->pos = -1;
+		if (av_interleaved_write_frame(oc, pkt) < 0)
+			goto cleanup;
+
+		if (job->progress && in_io.size > 0) {
+			const int percent = (int)(os_ftelli64(in_io.file) * 100 / in_io.size);
+			if (percent != last_percent) {
+				last_percent = percent;
+				pthread_mutex_lock(&remux_mutex);
+				if (remux_active_param)
+					job->progress(job->param, job->path, percent);
+				pthread_mutex_unlock(&remux_mutex);
+			}
+		}
+	}
+	if (ret != AVERROR_EOF) {
+		blog(LOG_WARNING, "[Vertical Canvas] error reading '%s' for remux: %s", job->path, av_err2str(ret));
+		goto cleanup;
+	}
+	success = av_write_trailer(oc) == 0;
+
+cleanup:
+	av_packet_free(&pkt);
+	bfree(stream_map);
+	if (oc) {
+		if (oc->pb) {
+			avio_flush(oc->pb);
+			av_freep(&oc->pb->buffer);
+			avio_context_free(&oc->pb);
+		}
+		avformat_free_context(oc);
+	}
+	avformat_close_input(&ic);
+	if (in_pb) {
+		av_freep(&in_pb->buffer);
+		avio_context_free(&in_pb);
+	}
+	if (out_io.file)
+		fclose(out_io.file);
+	fclose(in_io.file);
+	if (!success)
+		os_unlink(job->output);
+	return success;
+}
+
+static void *remux_queue_thread(void *data)
+{
+	UNUSED_PARAMETER(data);
+	os_set_thread_name("vertical-remux");
+	remux_lower_priority();
+	while (os_sem_wait(remux_sem) == 0) {
+		pthread_mutex_lock(&remux_mutex);
+		if (os_atomic_load_bool(&remux_stop)) {
+			pthread_mutex_unlock(&remux_mutex);
+			break;
+		}
+		if (!remux_jobs.num) {
+			pthread_mutex_unlock(&remux_mutex);
+			continue;
+		}
+		struct remux_job job = remux_jobs.array[0];
+		da_erase(remux_jobs, 0);
+		remux_active_param = job.param;
+		pthread_mutex_unlock(&remux_mutex);
+
+		blog(LOG_INFO, "[Vertical Canvas] remuxing '%s' to '%s'", job.path, job.output);
+		const bool success = remux_file(&job);
+		if (!success)
+			blog(LOG_WARNING, "[Vertical Canvas] failed to remux '%s'", job.path);
+
+		pthread_mutex_lock(&remux_mutex);
+		if (job.finished && remux_active_param)
+			job.finished(job.param, job.path, job.output, success);
+		remux_active_param = NULL;
+		pthread_mutex_unlock(&remux_mutex);
+		remux_job_free(&job);
+	}
+	return NULL;
+}
+
+bool remux_queue_add(const char *path, remux_progress_callback_t progress, remux_finished_callback_t finished, void *param)
+{
+	const char *ext = os_get_path_extension(path);
+	if (!ext || astrcmpi(ext, ".mp4") == 0 || astrcmpi(ext, ".mov") == 0 || astrcmpi(ext, ".m3u8") == 0)
+		return false;
+
+	struct dstr output = {0};
+	dstr_ncopy(&output, path, ext - path);
+	dstr_cat(&output, ".mp4");
+	if (os_file_exists(output.array)) {
+		blog(LOG_WARNING, "[Vertical Canvas] not remuxing '%s', '%s' already exists", path, output.array);
+		dstr_free(&output);
+		return false;
+	}
+
+	struct remux_job job = {0};
+	job.path = bstrdup(path);
+	job.output = output.array;
+	job.progress = progress;
+	job.finished = finished;
+	job.param = param;
+
+	pthread_mutex_lock(&remux_mutex);
+	if (!remux_sem) {
+		os_sem_init(&remux_sem, 0);
+		os_atomic_set_bool(&remux_stop, false);
+		if (pthread_create(&remux_thread, NULL, remux_queue_thread, NULL) == 0)
+			remux_thread_created = true;
+	}
+	da_push_back(remux_jobs, &job);
+	pthread_mutex_unlock(&remux_mutex);
+	os_sem_post(remux_sem);
+	return true;
+}
+
+void remux_queue_remove_param(void *param)
+{
+	pthread_mutex_lock(&remux_mutex);
+	for (size_t i = remux_jobs.num; i > 0; i--) {
+		if (remux_jobs.array[i - 1].param != param)
+			continue;
+		remux_job_free(remux_jobs.array + i - 1);
+		da_erase(remux_jobs, i - 1);
+	}
+	// the running job keeps going, its result is just no longer reported
+	if (remux_active_param == param)
+		remux_active_param = NULL;
+	pthread_mutex_unlock(&remux_mutex);
+}
+
+void remux_queue_free(void)
+{
+	if (!remux_sem)
+		return;
+	os_atomic_set_bool(&remux_stop, true);
+	os_sem_post(remux_sem);
+	if (remux_thread_created)
+		pthread_join(remux_thread, NULL);
+	remux_thread_created = false;
+
+	for (size_t i = 0; i < remux_jobs.num; i++)
+		remux_job_free(remux_jobs.array + i);
+	da_free(remux_jobs);
+	os_sem_destroy(remux_sem);
+	remux_sem = NULL;
+}
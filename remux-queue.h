@@ -0,0 +1,18 @@
+#pragma once
+
+#include <util/darray.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*remux_progress_callback_t)(void *param, const char *path, int percent);
+typedef void (*remux_finished_callback_t)(void *param, const char *path, const char *output, bool success);
+
+bool remux_queue_add(const char *path, remux_progress_callback_t progress, remux_finished_callback_t finished, void *param);
+void remux_queue_remove_param(void *param);
+void remux_queue_free(void);
+
+#ifdef __cplusplus
+};
+#endif
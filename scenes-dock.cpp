@@ -2,6 +2,7 @@
 
 #include "scenes-dock.hpp"
 
+#include <algorithm>
 #include <QMenu>
 #include <QToolBar>
 #include <QWidgetAction>
@@ -10,9 +11,236 @@
 #include "obs-module.h"
 #include "vertical-canvas.hpp"
 
+CanvasScenesModel::CanvasScenesModel(QObject *parent) : QAbstractListModel(parent) {}
+
+const CanvasScenesModel::SceneEntry *CanvasScenesModel::Entry(int row) const
+{
+	if (row < 0 || row >= order.size())
+		return nullptr;
+	auto it = store.constFind(order[row]);
+	return it == store.constEnd() ? nullptr : &it.value();
+}
+
+int CanvasScenesModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : (int)order.size();
+}
+
+QVariant CanvasScenesModel::data(const QModelIndex &index, int role) const
+{
+	const auto entry = index.isValid() ? Entry(index.row()) : nullptr;
+	if (!entry)
+		return QVariant();
+	if (role == Qt::DisplayRole)
+		return entry->name;
+	if (role == Qt::DecorationRole && thumbnails && !entry->thumbnail.isNull())
+		return entry->thumbnail;
+	if (role == Qt::UserRole)
+		return order[index.row()];
+	return QVariant();
+}
+
+void CanvasScenesModel::Add(obs_source_t *scene, int row)
+{
+	const QString uuid = QString::fromUtf8(obs_source_get_uuid(scene));
+	if (store.contains(uuid))
+		return;
+	if (row < 0 || row > order.size())
+		row = (int)order.size();
+	const QString name = QString::fromUtf8(obs_source_get_name(scene));
+	beginInsertRows(QModelIndex(), row, row);
+	order.insert(row, uuid);
+	store.insert(uuid, {name, OBSGetWeakRef(scene)});
+	if (!rowsDirty && row == order.size() - 1)
+		rows.insert(name, row);
+	else
+		rowsDirty = true;
+	endInsertRows();
+}
+
+void CanvasScenesModel::Remove(const QString &name)
+{
+	const int row = Row(name);
+	if (row < 0)
+		return;
+	beginRemoveRows(QModelIndex(), row, row);
+	store.remove(order[row]);
+	order.remove(row);
+	if (row == order.size())
+		rows.remove(name);
+	else
+		rowsDirty = true;
+	endRemoveRows();
+}
+
+void CanvasScenesModel::Rename(obs_source_t *scene, const QString &prevName, const QString &newName)
+{
+	auto it = store.find(QString::fromUtf8(obs_source_get_uuid(scene)));
+	if (it == store.end())
+		return;
+	it->name = newName;
+	if (!rowsDirty) {
+		const int row = rows.value(prevName, -1);
+		rows.remove(prevName);
+		if (row >= 0)
+			rows.insert(newName, row);
+		else
+			rowsDirty = true;
+	}
+	const int row = Row(newName);
+	if (row >= 0)
+		emit dataChanged(index(row), index(row));
+}
+
+void CanvasScenesModel::Move(int from, int to)
+{
+	if (from == to || from < 0 || to < 0 || from >= order.size() || to >= order.size())
+		return;
+	if (!beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to))
+		return;
+	order.move(from, to);
+	rowsDirty = true;
+	endMoveRows();
+}
+
+void CanvasScenesModel::Clear()
+{
+	beginResetModel();
+	order.clear();
+	store.clear();
+	rows.clear();
+	rowsDirty = false;
+	endResetModel();
+}
+
+// stable sort by the "order" saved in each scene, returns the row of the scene saved as active
+int CanvasScenesModel::SortBySavedOrder()
+{
+	struct SortEntry {
+		long long order;
+		int row;
+		bool active;
+	};
+	std::vector<SortEntry> entries;
+	entries.reserve(order.size());
+	for (int i = 0; i < order.size(); i++) {
+		OBSSource scene = Source(i);
+		OBSDataAutoRelease settings = scene ? obs_source_get_settings(scene) : nullptr;
+		entries.push_back({settings ? obs_data_get_int(settings, "order") : (long long)i, i,
+				   settings && obs_data_get_bool(settings, "canvas_active")});
+	}
+	std::stable_sort(entries.begin(), entries.end(), [](const SortEntry &a, const SortEntry &b) { return a.order < b.order; });
+
+	int active = -1;
+	bool changed = false;
+	for (int i = 0; i < (int)entries.size(); i++) {
+		if (entries[i].active)
+			active = i;
+		if (entries[i].row != i)
+			changed = true;
+	}
+	if (!changed)
+		return active;
+
+	emit layoutAboutToBeChanged();
+	QVector<QString> sorted;
+	sorted.reserve(order.size());
+	QVector<int> newRows(order.size());
+	for (int i = 0; i < (int)entries.size(); i++) {
+		sorted.push_back(order[entries[i].row]);
+		newRows[entries[i].row] = i;
+	}
+	order = sorted;
+	rowsDirty = true;
+	const QModelIndexList from = persistentIndexList();
+	QModelIndexList to;
+	to.reserve(from.size());
+	for (const auto &idx : from)
+		to.push_back(index(newRows[idx.row()]));
+	changePersistentIndexList(from, to);
+	emit layoutChanged();
+	return active;
+}
+
+void CanvasScenesModel::SetThumbnailsEnabled(bool enable)
+{
+	if (thumbnails == enable)
+		return;
+	thumbnails = enable;
+	if (!enable) {
+		for (auto &entry : store)
+			entry.thumbnail = QPixmap();
+	}
+	if (!order.isEmpty())
+		emit dataChanged(index(0), index((int)order.size() - 1), {Qt::DecorationRole});
+}
+
+void CanvasScenesModel::SetThumbnail(const QString &uuid, const QImage &image)
+{
+	if (!thumbnails)
+		return;
+	auto it = store.find(uuid);
+	if (it == store.end())
+		return;
+	it->thumbnail = QPixmap::fromImage(image);
+	const int row = Row(it->name);
+	if (row >= 0)
+		emit dataChanged(index(row), index(row), {Qt::DecorationRole});
+}
+
+int CanvasScenesModel::Row(const QString &name) const
+{
+	if (rowsDirty) {
+		rows.clear();
+		rows.reserve(order.size());
+		for (int i = 0; i < order.size(); i++)
+			rows.insert(Entry(i)->name, i);
+		rowsDirty = false;
+	}
+	return rows.value(name, -1);
+}
+
+QString CanvasScenesModel::Name(int row) const
+{
+	const auto entry = Entry(row);
+	return entry ? entry->name : QString();
+}
+
+OBSSource CanvasScenesModel::Source(int row) const
+{
+	const auto entry = Entry(row);
+	return entry ? OBSGetStrongRef(entry->source) : OBSSource();
+}
+
+int CanvasScenesDock::CurrentRow() const
+{
+	const auto index = sceneList->currentIndex();
+	return index.isValid() ? index.row() : -1;
+}
+
+QString CanvasScenesDock::CurrentName() const
+{
+	return sceneModel->Name(CurrentRow());
+}
+
+OBSSource CanvasScenesDock::CurrentSource() const
+{
+	return sceneModel->Source(CurrentRow());
+}
+
+void CanvasScenesDock::SetCurrentRow(int row)
+{
+	const auto index = sceneModel->index(row);
+	if (!index.isValid())
+		return;
+	sceneList->selectionModel()->setCurrentIndex(index, QItemSelectionModel::ClearAndSelect);
+}
+
 void CanvasScenesDock::SetGridMode(bool checked)
 {
+	canvasDock->SetSceneThumbnails(checked);
 	if (checked) {
+		sceneList->setIconSize(canvasDock->GetThumbnailSize());
 		sceneList->setResizeMode(QListView::Adjust);
 		sceneList->setViewMode(QListView::IconMode);
 		sceneList->setUniformItemSizes(true);
@@ -29,7 +257,7 @@ bool CanvasScenesDock::IsGridMode()
 	return sceneList->viewMode() == QListView::IconMode;
 }
 
-void CanvasScenesDock::ShowScenesContextMenu(QListWidgetItem *widget_item)
+void CanvasScenesDock::ShowScenesContextMenu(const QModelIndex &index)
 {
 	auto menu = QMenu(this);
 	auto a = menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.GridMode")),
@@ -37,35 +265,31 @@ void CanvasScenesDock::ShowScenesContextMenu(QListWidgetItem *widget_item)
 	a->setCheckable(true);
 	a->setChecked(IsGridMode());
 	menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Add")), [this] { canvasDock->AddScene(); });
-	if (!widget_item) {
+	if (!index.isValid()) {
 		menu.exec(QCursor::pos());
 		return;
 	}
 	menu.addSeparator();
 	menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Duplicate")), [this] {
-		auto item = sceneList->currentItem();
-		if (!item) {
+		const auto name = CurrentName();
+		if (name.isEmpty()) {
 			return;
 		}
-		canvasDock->AddScene(item->text());
+		canvasDock->AddScene(name);
 	});
 	menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Remove")), [this] {
-		auto item = sceneList->currentItem();
-		if (!item) {
+		const auto name = CurrentName();
+		if (name.isEmpty()) {
 			return;
 		}
-		canvasDock->RemoveScene(item->text());
+		canvasDock->RemoveScene(name);
 	});
 	menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Rename")), [this] {
-		const auto item = sceneList->currentItem();
-		if (!item) {
-			return;
-		}
-		std::string name = item->text().toUtf8().constData();
-		obs_source_t *source = obs_canvas_get_source_by_name(canvasDock->canvas, name.c_str());
+		OBSSource source = CurrentSource();
 		if (!source) {
 			return;
 		}
+		std::string name = obs_source_get_name(source);
 		obs_source_t *s = nullptr;
 		do {
 			obs_source_release(s);
@@ -78,44 +302,33 @@ void CanvasScenesDock::ShowScenesContextMenu(QListWidgetItem *widget_item)
 			}
 			obs_source_set_name(source, name.c_str());
 		} while (s);
-		obs_source_release(source);
 	});
 	auto orderMenu = menu.addMenu(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Order")));
 	orderMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Order.MoveUp")),
 			     [this] { ChangeSceneIndex(true, -1, 0); });
 	orderMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Order.MoveDown")),
-			     [this] { ChangeSceneIndex(true, 1, sceneList->count() - 1); });
+			     [this] { ChangeSceneIndex(true, 1, sceneModel->rowCount() - 1); });
 	orderMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Order.MoveToTop")),
 			     [this] { ChangeSceneIndex(false, 0, 0); });
 	orderMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Order.MoveToBottom")),
-			     [this] { ChangeSceneIndex(false, 1, sceneList->count() - 1); });
+			     [this] { ChangeSceneIndex(false, 1, sceneModel->rowCount() - 1); });
 
 	menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Screenshot.Scene")), [this] {
-		auto item = sceneList->currentItem();
-		if (!item) {
-			return;
-		}
-		auto s = obs_canvas_get_source_by_name(canvasDock->canvas, item->text().toUtf8().constData());
+		OBSSource s = CurrentSource();
 		if (s) {
 			obs_frontend_take_source_screenshot(s);
-			obs_source_release(s);
 		}
 	});
 	menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Filters")), [this] {
-		auto item = sceneList->currentItem();
-		if (!item) {
-			return;
-		}
-		auto s = obs_canvas_get_source_by_name(canvasDock->canvas, item->text().toUtf8().constData());
+		OBSSource s = CurrentSource();
 		if (s) {
 			obs_frontend_open_source_filters(s);
-			obs_source_release(s);
 		}
 	});
 
 	auto tom = menu.addMenu(QString::fromUtf8(obs_frontend_get_locale_string("TransitionOverride")));
-	std::string scene_name = widget_item->text().toUtf8().constData();
-	OBSSourceAutoRelease scene_source = obs_canvas_get_source_by_name(canvasDock->canvas, scene_name.c_str());
+	std::string scene_name = sceneModel->Name(index.row()).toUtf8().constData();
+	OBSSource scene_source = sceneModel->Source(index.row());
 	OBSDataAutoRelease private_settings = obs_source_get_private_settings(scene_source);
 	obs_data_set_default_int(private_settings, "transition_duration", 300);
 	const char *curTransition = obs_data_get_string(private_settings, "transition");
@@ -173,55 +386,29 @@ void CanvasScenesDock::ShowScenesContextMenu(QListWidgetItem *widget_item)
 		linkedScenesMenu->clear();
 		struct obs_frontend_source_list scenes = {};
 		obs_frontend_get_scenes(&scenes);
+		OBSSource current = CurrentSource();
 		for (size_t i = 0; i < scenes.sources.num; i++) {
 			obs_source_t *src = scenes.sources.array[i];
-			obs_data_t *settings = obs_source_get_settings(src);
 
 			auto name = QString::fromUtf8(obs_source_get_name(src));
 			auto *checkBox = new QCheckBox(name, linkedScenesMenu);
+			checkBox->setChecked(current && canvasDock->GetLinkedScene(src) == current);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
 			connect(checkBox, &QCheckBox::checkStateChanged, [this, src, checkBox] {
 #else
 			connect(checkBox, &QCheckBox::stateChanged, [this, src, checkBox] {
 #endif
-				canvasDock->SetLinkedScene(src, checkBox->isChecked() ? sceneList->currentItem()->text() : "");
+				canvasDock->SetLinkedScene(src, checkBox->isChecked() ? CurrentName() : "");
 			});
 			auto *checkableAction = new QWidgetAction(linkedScenesMenu);
 			checkableAction->setDefaultWidget(checkBox);
 			linkedScenesMenu->addAction(checkableAction);
-
-			auto c = obs_data_get_array(settings, "canvas");
-			if (c) {
-				const auto count = obs_data_array_count(c);
-
-				for (size_t j = 0; j < count; j++) {
-					auto item = obs_data_array_item(c, j);
-					if (!item)
-						continue;
-					if (obs_data_get_int(item, "width") == canvasDock->canvas_width &&
-					    obs_data_get_int(item, "height") == canvasDock->canvas_height) {
-						auto sn = QString::fromUtf8(obs_data_get_string(item, "scene"));
-						if (sn == sceneList->currentItem()->text()) {
-							checkBox->setChecked(true);
-						}
-					}
-					obs_data_release(item);
-				}
-
-				obs_data_array_release(c);
-			}
-
-			obs_data_release(settings);
 		}
 		obs_frontend_source_list_free(&scenes);
 	});
 
 	menu.addAction(QString::fromUtf8(obs_module_text("OnMainCanvas")), [this] {
-		auto item = sceneList->currentItem();
-		if (!item) {
-			return;
-		}
-		auto s = obs_canvas_get_source_by_name(canvasDock->canvas, item->text().toUtf8().constData());
+		OBSSource s = CurrentSource();
 		if (!s) {
 			return;
 		}
@@ -231,13 +418,13 @@ void CanvasScenesDock::ShowScenesContextMenu(QListWidgetItem *widget_item)
 		} else {
 			obs_frontend_set_current_scene(s);
 		}
-		obs_source_release(s);
 	});
 
 	a = menu.addAction(QString::fromUtf8(obs_frontend_get_locale_string("ShowInMultiview")), [this, scene_name](bool checked) {
 		OBSSourceAutoRelease source = obs_canvas_get_source_by_name(canvasDock->canvas, scene_name.c_str());
 		OBSDataAutoRelease ps = obs_source_get_private_settings(source);
 		obs_data_set_bool(ps, "show_in_multiview", checked);
+		canvasDock->UpdateMultiviews();
 	});
 	a->setCheckable(true);
 	obs_data_set_default_bool(private_settings, "show_in_multiview", true);
@@ -245,39 +432,49 @@ void CanvasScenesDock::ShowScenesContextMenu(QListWidgetItem *widget_item)
 	menu.exec(QCursor::pos());
 }
 
-CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : QFrame(parent), canvasDock(canvas_dock)
+CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent)
+	: QFrame(parent),
+	  sceneModel(canvas_dock->sceneModel),
+	  canvasDock(canvas_dock)
 {
 	setMinimumWidth(100);
 	setMinimumHeight(50);
 
 	auto mainLayout = new QVBoxLayout(this);
 	mainLayout->setContentsMargins(0, 0, 0, 0);
-	sceneList = new QListWidget();
+	sceneList = new QListView();
+	sceneList->setModel(sceneModel);
+	sceneList->setEditTriggers(QAbstractItemView::NoEditTriggers);
 	sceneList->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding);
 	sceneList->setFrameShape(QFrame::NoFrame);
 	sceneList->setFrameShadow(QFrame::Plain);
 	sceneList->setSelectionMode(QAbstractItemView::SingleSelection);
 	sceneList->setContextMenuPolicy(Qt::CustomContextMenu);
-	connect(sceneList, &QListWidget::customContextMenuRequested,
-		[this](const QPoint &pos) { ShowScenesContextMenu(sceneList->itemAt(pos)); });
+	connect(sceneList, &QListView::customContextMenuRequested,
+		[this](const QPoint &pos) { ShowScenesContextMenu(sceneList->indexAt(pos)); });
+	sceneList->setMouseTracking(true);
+	connect(sceneList, &QListView::entered, [this](const QModelIndex &index) {
+		canvasDock->HoverPrewarmSource(index.isValid() ? sceneModel->Source(index.row()) : nullptr);
+	});
+	connect(sceneList, &QListView::viewportEntered, [this] { canvasDock->HoverPrewarmSource(nullptr); });
 
-	connect(sceneList, &QListWidget::currentItemChanged, [this]() {
-		const auto item = sceneList->currentItem();
-		if (!item || canvasDock->clearing || canvasDock->switching) {
+	auto selection = sceneList->selectionModel();
+	connect(selection, &QItemSelectionModel::currentChanged, [this](const QModelIndex &current) {
+		if (!current.isValid() || canvasDock->clearing || canvasDock->switching) {
 			return;
 		}
-		canvasDock->SwitchScene(item->text());
-		if (!item->isSelected()) {
-			item->setSelected(true);
+		canvasDock->SwitchScene(sceneModel->Name(current.row()));
+		if (!sceneList->selectionModel()->isSelected(current)) {
+			sceneList->selectionModel()->select(current, QItemSelectionModel::Select);
 		}
 	});
-	connect(sceneList, &QListWidget::itemSelectionChanged, [this] {
-		const auto item = sceneList->currentItem();
-		if (!item) {
+	connect(selection, &QItemSelectionModel::selectionChanged, [this] {
+		const auto current = sceneList->currentIndex();
+		if (!current.isValid()) {
 			return;
 		}
-		if (!item->isSelected()) {
-			item->setSelected(true);
+		if (!sceneList->selectionModel()->isSelected(current)) {
+			sceneList->selectionModel()->select(current, QItemSelectionModel::Select);
 		}
 	});
 
@@ -289,11 +486,7 @@ CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : Q
 #endif
 	renameAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
 	connect(renameAction, &QAction::triggered, [this]() {
-		const auto item = sceneList->currentItem();
-		if (!item) {
-			return;
-		}
-		obs_source_t *source = obs_canvas_get_source_by_name(canvasDock->canvas, item->text().toUtf8().constData());
+		OBSSource source = CurrentSource();
 		if (!source) {
 			return;
 		}
@@ -310,7 +503,6 @@ CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : Q
 			}
 			obs_source_set_name(source, name.c_str());
 		} while (s);
-		obs_source_release(source);
 	});
 	sceneList->addAction(renameAction);
 
@@ -327,11 +519,11 @@ CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : Q
 
 	a = toolbar->addAction(QIcon(":/res/images/minus.svg"), QString::fromUtf8(obs_frontend_get_locale_string("RemoveScene")),
 			       [this] {
-				       auto item = sceneList->currentItem();
-				       if (!item) {
+				       const auto name = CurrentName();
+				       if (name.isEmpty()) {
 					       return;
 				       }
-				       canvasDock->RemoveScene(item->text());
+				       canvasDock->RemoveScene(name);
 			       });
 	toolbar->widgetForAction(a)->setProperty("themeID", QVariant(QString::fromUtf8("removeIconSmall")));
 	toolbar->widgetForAction(a)->setProperty("class", "icon-minus");
@@ -345,16 +537,11 @@ CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : Q
 	toolbar->addSeparator();
 	a = toolbar->addAction(
 		QIcon(":/res/images/filter.svg"), QString::fromUtf8(obs_frontend_get_locale_string("SceneFilters")), [this] {
-			auto item = sceneList->currentItem();
-			if (!item) {
-				return;
-			}
-			auto s = obs_canvas_get_source_by_name(canvasDock->canvas, item->text().toUtf8().constData());
+			OBSSource s = CurrentSource();
 			if (!s) {
 				return;
 			}
 			obs_frontend_open_source_filters(s);
-			obs_source_release(s);
 		});
 	toolbar->widgetForAction(a)->setProperty("themeID", QVariant(QString::fromUtf8("filtersIcon")));
 	toolbar->widgetForAction(a)->setProperty("class", "icon-filter");
@@ -364,7 +551,7 @@ CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : Q
 	toolbar->widgetForAction(a)->setProperty("themeID", QVariant(QString::fromUtf8("upArrowIconSmall")));
 	toolbar->widgetForAction(a)->setProperty("class", "icon-up");
 	a = toolbar->addAction(QIcon(":/res/images/down.svg"), QString::fromUtf8(obs_frontend_get_locale_string("MoveSceneDown")),
-			       [this] { ChangeSceneIndex(true, 1, sceneList->count() - 1); });
+			       [this] { ChangeSceneIndex(true, 1, sceneModel->rowCount() - 1); });
 	toolbar->widgetForAction(a)->setProperty("themeID", QVariant(QString::fromUtf8("downArrowIconSmall")));
 	toolbar->widgetForAction(a)->setProperty("class", "icon-down");
 	mainLayout->addWidget(toolbar, 0);
@@ -378,32 +565,29 @@ CanvasScenesDock::CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent) : Q
 
 void CanvasScenesDock::ChangeSceneIndex(bool relative, int offset, int invalidIdx)
 {
-	int idx = sceneList->currentRow();
+	int idx = CurrentRow();
 	if (idx < 0) {
 		return;
 	}
 
-	auto canvasItem = sceneList->item(idx);
-	if (!canvasItem) {
-		return;
-	}
-
 	if (idx == invalidIdx) {
 		return;
 	}
 
-	sceneList->blockSignals(true);
-	auto item = sceneList->takeItem(idx);
+	int target;
 	if (relative) {
-		sceneList->insertItem(idx + offset, item);
-		sceneList->setCurrentRow(idx + offset);
+		target = idx + offset;
 	} else if (offset == 0) {
-		sceneList->insertItem(offset, item);
+		target = 0;
 	} else {
-		sceneList->insertItem(sceneList->count(), item);
+		target = sceneModel->rowCount() - 1;
 	}
-	item->setSelected(true);
-	sceneList->blockSignals(false);
+
+	auto selection = sceneList->selectionModel();
+	selection->blockSignals(true);
+	sceneModel->Move(idx, target);
+	selection->setCurrentIndex(sceneModel->index(target), QItemSelectionModel::ClearAndSelect);
+	selection->blockSignals(false);
 }
 
 CanvasScenesDock::~CanvasScenesDock() {}
@@ -1,24 +1,72 @@
 #pragma once
 
+#include <QAbstractListModel>
 #include <QDockWidget>
-#include <QListWidget>
+#include <QHash>
+#include <QListView>
+#include <QPixmap>
+#include <QVector>
 #include <QWidget>
+#include <obs.hpp>
 
 class CanvasDock;
 
+class CanvasScenesModel : public QAbstractListModel {
+	Q_OBJECT
+
+	struct SceneEntry {
+		QString name;
+		OBSWeakSource source;
+		QPixmap thumbnail;
+	};
+
+	QVector<QString> order;
+	QHash<QString, SceneEntry> store;
+	mutable QHash<QString, int> rows;
+	mutable bool rowsDirty = false;
+	bool thumbnails = false;
+
+	const SceneEntry *Entry(int row) const;
+
+public:
+	explicit CanvasScenesModel(QObject *parent = nullptr);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role) const override;
+
+	void Add(obs_source_t *scene, int row = -1);
+	void Remove(const QString &name);
+	void Rename(obs_source_t *scene, const QString &prevName, const QString &newName);
+	void Move(int from, int to);
+	void Clear();
+	int SortBySavedOrder();
+	void SetThumbnailsEnabled(bool enable);
+	void SetThumbnail(const QString &uuid, const QImage &image);
+
+	int Row(const QString &name) const;
+	QString Name(int row) const;
+	OBSSource Source(int row) const;
+};
+
 class CanvasScenesDock : public QFrame {
 	Q_OBJECT
 	friend class CanvasDock;
 
 private:
-	QListWidget *sceneList;
+	QListView *sceneList;
+	CanvasScenesModel *sceneModel;
 	CanvasDock *canvasDock;
 
 	void ChangeSceneIndex(bool relative, int offset, int invalidIdx);
-	void ShowScenesContextMenu(QListWidgetItem *item);
+	void ShowScenesContextMenu(const QModelIndex &index);
 	void SetGridMode(bool checked);
 	bool IsGridMode();
 
+	int CurrentRow() const;
+	QString CurrentName() const;
+	OBSSource CurrentSource() const;
+	void SetCurrentRow(int row);
+
 public:
 	CanvasScenesDock(CanvasDock *canvas_dock, QWidget *parent = nullptr);
 	~CanvasScenesDock();
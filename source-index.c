@@ -0,0 +1,178 @@
+#include <obs-module.h>
+#include <util/threading.h>
+#include "source-index.h"
+
+struct source_type_index {
+	char *id;
+	DARRAY(obs_source_t *) sources;
+};
+
+static pthread_mutex_t index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DARRAY(struct source_type_index) index_types;
+static DARRAY(obs_source_t *) index_scenes;
+static volatile long scene_generation = 0;
+static bool index_active = false;
+
+static void source_index_scene_changed(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(cd);
+	os_atomic_inc_long(&scene_generation);
+}
+
+static struct source_type_index *source_index_find_type(const char *id, bool create)
+{
+	for (size_t i = 0; i < index_types.num; i++) {
+		if (strcmp(index_types.array[i].id, id) == 0)
+			return index_types.array + i;
+	}
+	if (!create)
+		return NULL;
+	struct source_type_index *t = da_push_back_new(index_types);
+	t->id = bstrdup(id);
+	return t;
+}
+
+static void source_index_add(obs_source_t *source, bool unique)
+{
+	// private sources never emit the global create and destroy signals, so they could not be dropped again
+	if (obs_obj_is_private(source))
+		return;
+
+	const char *id = obs_source_get_unversioned_id(source);
+	if (!id)
+		return;
+
+	const enum obs_source_type type = obs_source_get_type(source);
+	const bool is_group = strcmp(id, "group") == 0;
+
+	pthread_mutex_lock(&index_mutex);
+	if (type == OBS_SOURCE_TYPE_SCENE && (!unique || da_find(index_scenes, &source, 0) == DARRAY_INVALID)) {
+		signal_handler_t *sh = obs_source_get_signal_handler(source);
+		signal_handler_connect(sh, "item_add", source_index_scene_changed, NULL);
+		signal_handler_connect(sh, "item_remove", source_index_scene_changed, NULL);
+		da_push_back(index_scenes, &source);
+		os_atomic_inc_long(&scene_generation);
+	}
+	if (type == OBS_SOURCE_TYPE_INPUT || is_group) {
+		struct source_type_index *t = source_index_find_type(id, true);
+		if (!unique || da_find(t->sources, &source, 0) == DARRAY_INVALID)
+			da_push_back(t->sources, &source);
+	}
+	pthread_mutex_unlock(&index_mutex);
+}
+
+static void source_index_source_create(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_source_t *source = calldata_ptr(cd, "source");
+	if (source)
+		source_index_add(source, false);
+}
+
+static void source_index_source_destroy(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	obs_source_t *source = calldata_ptr(cd, "source");
+	if (!source)
+		return;
+
+	const char *id = obs_source_get_unversioned_id(source);
+
+	pthread_mutex_lock(&index_mutex);
+	size_t idx = da_find(index_scenes, &source, 0);
+	if (idx != DARRAY_INVALID) {
+		signal_handler_t *sh = obs_source_get_signal_handler(source);
+		signal_handler_disconnect(sh, "item_add", source_index_scene_changed, NULL);
+		signal_handler_disconnect(sh, "item_remove", source_index_scene_changed, NULL);
+		da_erase(index_scenes, idx);
+	}
+	struct source_type_index *t = id ? source_index_find_type(id, false) : NULL;
+	if (t)
+		da_erase_item(t->sources, &source);
+	pthread_mutex_unlock(&index_mutex);
+	os_atomic_inc_long(&scene_generation);
+}
+
+static bool source_index_enum_existing(void *param, obs_source_t *source)
+{
+	UNUSED_PARAMETER(param);
+	source_index_add(source, true);
+	return true;
+}
+
+// keeps public inputs grouped by type so the add source menus do not have to walk every source
+void source_index_init(void)
+{
+	if (index_active)
+		return;
+	index_active = true;
+
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_connect(sh, "source_create", source_index_source_create, NULL);
+	signal_handler_connect(sh, "source_destroy", source_index_source_destroy, NULL);
+
+	obs_enum_all_sources(source_index_enum_existing, NULL);
+}
+
+void source_index_free(void)
+{
+	if (!index_active)
+		return;
+	index_active = false;
+
+	signal_handler_t *sh = obs_get_signal_handler();
+	signal_handler_disconnect(sh, "source_create", source_index_source_create, NULL);
+	signal_handler_disconnect(sh, "source_destroy", source_index_source_destroy, NULL);
+
+	pthread_mutex_lock(&index_mutex);
+	for (size_t i = 0; i < index_scenes.num; i++) {
+		signal_handler_t *scene_sh = obs_source_get_signal_handler(index_scenes.array[i]);
+		signal_handler_disconnect(scene_sh, "item_add", source_index_scene_changed, NULL);
+		signal_handler_disconnect(scene_sh, "item_remove", source_index_scene_changed, NULL);
+	}
+	da_free(index_scenes);
+	for (size_t i = 0; i < index_types.num; i++) {
+		bfree(index_types.array[i].id);
+		da_free(index_types.array[i].sources);
+	}
+	da_free(index_types);
+	pthread_mutex_unlock(&index_mutex);
+}
+
+void source_index_enum_type(const char *unversioned_id, source_index_enum_proc_t enum_proc, void *param)
+{
+	DARRAY(obs_source_t *) refs;
+	da_init(refs);
+
+	pthread_mutex_lock(&index_mutex);
+	struct source_type_index *t = source_index_find_type(unversioned_id, false);
+	if (t) {
+		da_reserve(refs, t->sources.num);
+		for (size_t i = 0; i < t->sources.num; i++) {
+			obs_source_t *source = obs_source_get_ref(t->sources.array[i]);
+			if (!source)
+				continue;
+			if (obs_source_removed(source)) {
+				obs_source_release(source);
+				continue;
+			}
+			da_push_back(refs, &source);
+		}
+	}
+	pthread_mutex_unlock(&index_mutex);
+
+	bool enumerate = true;
+	for (size_t i = 0; i < refs.num; i++) {
+		if (enumerate)
+			enumerate = enum_proc(param, refs.array[i]);
+		obs_source_release(refs.array[i]);
+	}
+	da_free(refs);
+}
+
+// bumped whenever a scene gains or loses an item or a source is destroyed, so cached cycle checks know when to recompute
+long source_index_scene_generation(void)
+{
+	return os_atomic_load_long(&scene_generation);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <util/darray.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef bool (*source_index_enum_proc_t)(void *param, obs_source_t *source);
+
+void source_index_init(void);
+void source_index_free(void);
+void source_index_enum_type(const char *unversioned_id, source_index_enum_proc_t enum_proc, void *param);
+long source_index_scene_generation(void);
+
+#ifdef __cplusplus
+};
+#endif
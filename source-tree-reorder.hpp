@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+struct ReorderStep {
+	bool insert;
+	int src;   /* first row to move, -1 for inserts */
+	int dest;  /* row to move before or insert at, counted before the step */
+	int first; /* index in the new order of the first row of the step */
+	int count;
+};
+
+/* plans the fewest model moves that turn the current rows into the new order.
+ * oldRows holds the current row of every row in the new order, or -1 for rows
+ * that are not in the model yet. every current row has to be in the new order.
+ *
+ * rows on the longest increasing run of new positions stay put and every other
+ * row is moved or inserted directly after its new predecessor. each row gets a
+ * fixed slot in the final order up front and a fenwick tree over the occupied
+ * slots turns a slot into its current row, so the plan is O(n log n) */
+static inline std::vector<ReorderStep> PlanReorder(const std::vector<int> &oldRows, int current)
+{
+	const int count = (int)oldRows.size();
+
+	std::vector<int> positions(current, -1);
+	for (int k = 0; k < count; k++)
+		if (oldRows[k] >= 0)
+			positions[oldRows[k]] = k;
+
+	std::vector<int> tails;
+	std::vector<int> prev(current, -1);
+	for (int i = 0; i < current; i++) {
+		auto it = std::lower_bound(tails.begin(), tails.end(), positions[i],
+					   [&positions](int idx, int value) { return positions[idx] < value; });
+		if (it != tails.begin())
+			prev[i] = *(it - 1);
+		if (it == tails.end())
+			tails.push_back(i);
+		else
+			*it = i;
+	}
+
+	std::vector<bool> keep(count, false);
+	for (int i = tails.empty() ? -1 : tails.back(); i >= 0; i = prev[i])
+		keep[positions[i]] = true;
+
+	/* slot order: the rows placed before the first kept row, then every current
+	 * row followed by the rows placed after it */
+	std::vector<int> chainOf(count, 0);
+	std::vector<int> chainLen(current + 1, 0);
+	int head = 0;
+	for (int k = 0; k < count; k++) {
+		if (keep[k]) {
+			head = oldRows[k] + 1;
+			continue;
+		}
+		chainOf[k] = head;
+		chainLen[head]++;
+	}
+
+	std::vector<int> chainNext(current + 1, 0);
+	std::vector<int> rowSlot(current, 0);
+	int slots = chainLen[0];
+	for (int i = 0; i < current; i++) {
+		rowSlot[i] = slots++;
+		chainNext[i + 1] = slots;
+		slots += chainLen[i + 1];
+	}
+
+	std::vector<int> target(count, 0);
+	for (int k = 0; k < count; k++)
+		target[k] = keep[k] ? rowSlot[oldRows[k]] : chainNext[chainOf[k]]++;
+
+	std::vector<int> tree(slots + 1, 0);
+	auto occupy = [&tree, slots](int slot, int delta) {
+		for (slot++; slot <= slots; slot += slot & -slot)
+			tree[slot] += delta;
+	};
+	auto rowOf = [&tree](int slot) {
+		int row = 0;
+		for (; slot > 0; slot -= slot & -slot)
+			row += tree[slot];
+		return row;
+	};
+	for (int i = 0; i < current; i++)
+		occupy(rowSlot[i], 1);
+
+	/* batch consecutive rows into one step */
+	std::vector<ReorderStep> steps;
+	for (int k = 0; k < count;) {
+		if (keep[k]) {
+			k++;
+			continue;
+		}
+
+		const int dest = rowOf(target[k]);
+		int run = 1;
+
+		if (oldRows[k] < 0) {
+			while (k + run < count && !keep[k + run] && oldRows[k + run] < 0)
+				run++;
+
+			steps.push_back({true, -1, dest, k, run});
+		} else {
+			const int src = rowOf(rowSlot[oldRows[k]]);
+			while (k + run < count && !keep[k + run] && oldRows[k + run] >= 0 &&
+			       rowOf(rowSlot[oldRows[k + run]]) == src + run)
+				run++;
+
+			if (dest < src || dest > src + run)
+				steps.push_back({false, src, dest, k, run});
+			for (int i = 0; i < run; i++)
+				occupy(rowSlot[oldRows[k + i]], -1);
+		}
+
+		for (int i = 0; i < run; i++)
+			occupy(target[k + i], 1);
+		k += run;
+	}
+
+	return steps;
+}
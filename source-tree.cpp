@@ -16,6 +16,7 @@
 #include <string>
 
 #include "obs-module.h"
+#include "source-tree-reorder.hpp"
 #include "vertical-canvas.hpp"
 
 
@@ -77,6 +78,17 @@ static QIcon GetIconFromType(enum obs_icon_type icon_type)
 	}
 }
 
+static QIcon GetSourceIcon(obs_source_t *source)
+{
+	const char *id = obs_source_get_id(source);
+
+	if (strcmp(id, "scene") == 0)
+		return GetSceneIcon();
+	else if (strcmp(id, "group") == 0)
+		return GetGroupIcon();
+	return GetIconFromType(obs_source_get_icon_type(id));
+}
+
 SourceTreeItem::SourceTreeItem(SourceTree *tree_, OBSSceneItem sceneitem_) : tree(tree_), sceneitem(sceneitem_)
 {
 	setAttribute(Qt::WA_TranslucentBackground);
@@ -101,21 +113,10 @@ SourceTreeItem::SourceTreeItem(SourceTree *tree_, OBSSceneItem sceneitem_) : tre
 	}
 
 	//OBSBasic *main = reinterpret_cast<OBSBasic *>(App()->GetMainWindow());
-	const char *id = obs_source_get_id(source);
-
 	bool sourceVisible = obs_sceneitem_visible(sceneitem);
 
 	if (tree->iconsVisible) {
-		QIcon icon;
-
-		if (strcmp(id, "scene") == 0)
-			icon = GetSceneIcon();
-		else if (strcmp(id, "group") == 0)
-			icon = GetGroupIcon();
-		else
-			icon = GetIconFromType(obs_source_get_icon_type(id));
-
-		QPixmap pixmap = icon.pixmap(QSize(16, 16));
+		QPixmap pixmap = GetSourceIcon(source).pixmap(QSize(16, 16));
 
 		iconLabel = new QLabel();
 		iconLabel->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
@@ -190,10 +191,7 @@ SourceTreeItem::SourceTreeItem(SourceTree *tree_, OBSSceneItem sceneitem_) : tre
 	connect(lock, &QAbstractButton::clicked, setItemLocked);
 }
 
-SourceTreeItem::~SourceTreeItem()
-{
-	DisconnectSignals();
-}
+SourceTreeItem::~SourceTreeItem() {}
 
 void SourceTreeItem::paintEvent(QPaintEvent *event)
 {
@@ -205,132 +203,8 @@ void SourceTreeItem::paintEvent(QPaintEvent *event)
 	QWidget::paintEvent(event);
 }
 
-void SourceTreeItem::DisconnectSignals()
-{
-	sigs.clear();
-}
-
-void SourceTreeItem::Clear()
-{
-	DisconnectSignals();
-	sceneitem = nullptr;
-}
-
 extern std::list<CanvasDock *> canvas_docks;
 
-
-
-
-void SourceTreeItem::removeScene(void *data, calldata_t *)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	QMetaObject::invokeMethod(this_, "Clear");
-}
-
-void SourceTreeItem::removeItem(void *data, calldata_t *cd)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	if (!this_->tree)
-		return;
-	obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-	obs_scene_t *curScene = (obs_scene_t *)calldata_ptr(cd, "scene");
-
-	if (curItem == this_->sceneitem) {
-		QMetaObject::invokeMethod(this_->tree, "Remove", Q_ARG(OBSSceneItem, curItem), Q_ARG(OBSScene, curScene));
-		QMetaObject::invokeMethod(this_, "Clear");
-	}		
-}
-
-void SourceTreeItem::itemVisible(void *data, calldata_t *cd)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-	bool visible = calldata_bool(cd, "visible");
-
-	if (curItem == this_->sceneitem)
-		QMetaObject::invokeMethod(this_, "VisibilityChanged", Qt::QueuedConnection, Q_ARG(bool, visible));
-}
-
-void SourceTreeItem::itemLocked(void *data, calldata_t *cd)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-	bool locked = calldata_bool(cd, "locked");
-
-	if (curItem == this_->sceneitem)
-		QMetaObject::invokeMethod(this_, "LockedChanged", Qt::QueuedConnection, Q_ARG(bool, locked));
-}
-
-void SourceTreeItem::itemSelect(void *data, calldata_t *cd)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-
-	if (curItem == this_->sceneitem)
-		QMetaObject::invokeMethod(this_, "Select", Qt::QueuedConnection);
-}
-
-void SourceTreeItem::itemDeselect(void *data, calldata_t *cd)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-
-	if (curItem == this_->sceneitem)
-		QMetaObject::invokeMethod(this_, "Deselect", Qt::QueuedConnection);
-}
-
-void SourceTreeItem::reorderGroup(void *data, calldata_t *)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	QMetaObject::invokeMethod(this_->tree, "ReorderItems", Qt::QueuedConnection);
-};
-
-void SourceTreeItem::renamed(void *data, calldata_t *cd)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	const char *name = calldata_string(cd, "new_name");
-
-	QMetaObject::invokeMethod(this_, "Renamed", Qt::QueuedConnection, Q_ARG(QString, QString::fromUtf8(name)));
-}
-
-void SourceTreeItem::removeSource(void *data, calldata_t *)
-{
-	SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-	this_->DisconnectSignals();
-	this_->sceneitem = nullptr;
-	QMetaObject::invokeMethod(this_->tree, "RefreshItems", Qt::QueuedConnection);
-}
-
-void SourceTreeItem::ReconnectSignals()
-{
-	if (!sceneitem)
-		return;
-
-	DisconnectSignals();
-
-	obs_scene_t *scene = obs_sceneitem_get_scene(sceneitem);
-	obs_source_t *sceneSource = obs_scene_get_source(scene);
-	signal_handler_t *signal = obs_source_get_signal_handler(sceneSource);
-	sigs.emplace_back(signal, "remove", removeScene, this);
-	sigs.emplace_back(signal, "item_remove", removeItem, this);
-	sigs.emplace_back(signal, "item_visible", itemVisible, this);
-	sigs.emplace_back(signal, "item_locked", itemLocked, this);
-	sigs.emplace_back(signal, "item_select", itemSelect, this);
-	sigs.emplace_back(signal, "item_deselect", itemDeselect, this);
-
-	if (obs_sceneitem_is_group(sceneitem)) {
-		obs_source_t *source = obs_sceneitem_get_source(sceneitem);
-		signal = obs_source_get_signal_handler(source);
-
-		sigs.emplace_back(signal, "reorder", reorderGroup, this);
-	}
-
-	obs_source_t *source = obs_sceneitem_get_source(sceneitem);
-	signal = obs_source_get_signal_handler(source);
-	sigs.emplace_back(signal, "rename", renamed, this);
-	sigs.emplace_back(signal, "remove", removeSource, this);
-}
-
 void SourceTreeItem::mouseDoubleClickEvent(QMouseEvent *event)
 {
 	QWidget::mouseDoubleClickEvent(event);
@@ -564,8 +438,6 @@ void SourceTreeItem::Update(bool force)
 
 	/* ------------------------------------------------- */
 
-	ReconnectSignals();
-
 	if (spacer) {
 		boxLayout->removeItem(spacer);
 		delete spacer;
@@ -617,16 +489,6 @@ void SourceTreeItem::ExpandClicked(bool checked)
 		tree->GetStm()->CollapseGroup(sceneitem);
 }
 
-void SourceTreeItem::Select()
-{
-	tree->SelectItem(sceneitem, true);
-}
-
-void SourceTreeItem::Deselect()
-{
-	tree->SelectItem(sceneitem, false);
-}
-
 /* ========================================================================= */
 
 void SourceTreeModel::OBSFrontendEvent(enum obs_frontend_event event, void *ptr)
@@ -639,8 +501,10 @@ void SourceTreeModel::OBSFrontendEvent(enum obs_frontend_event event, void *ptr)
 		break;
 	case OBS_FRONTEND_EVENT_EXIT:
 	case OBS_FRONTEND_EVENT_SCRIPTING_SHUTDOWN:
+		stm->st->DisconnectSceneSignals();
 		if (!stm->items.isEmpty())
 			stm->items.clear();
+		stm->rowsDirty = true;
 		break;
 	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
 		stm->Clear();
@@ -652,6 +516,7 @@ void SourceTreeModel::OBSFrontendEvent(enum obs_frontend_event event, void *ptr)
 
 void SourceTreeModel::Clear()
 {
+	st->DisconnectSceneSignals();
 	if (items.isEmpty())
 		return;
 	beginResetModel();
@@ -715,80 +580,79 @@ static inline void MoveItem(QVector<OBSSceneItem> &items, int oldIdx, int newIdx
 	items.insert(newIdx, item);
 }
 
-/* reorders list optimally with model reorder funcs */
+/* moves a run of scene items to before newIdx */
+static inline void MoveItems(QVector<OBSSceneItem> &items, int oldIdx, int count, int newIdx)
+{
+	QVector<OBSSceneItem> moved = items.mid(oldIdx, count);
+	items.remove(oldIdx, count);
+	if (newIdx > oldIdx)
+		newIdx -= count;
+	for (int i = 0; i < count; i++)
+		items.insert(newIdx + i, moved[i]);
+}
+
+/* reorders list with the fewest model moves, see PlanReorder */
 void SourceTreeModel::ReorderItems()
 {
 	obs_scene_t *scene = st->canvasDock->scene;
 
 	QVector<OBSSceneItem> newitems;
 	obs_scene_enum_items(scene, enumItem, &newitems);
-
-	/* if item list has changed size, do full reset */
-	if (newitems.count() != items.count()) {
-		SceneChanged();
-		return;
+	const int count = (int)newitems.count();
+
+	QHash<obs_sceneitem_t *, int> newRows;
+	newRows.reserve(count);
+	for (int i = 0; i < count; i++)
+		newRows.insert(newitems[i], i);
+
+	bool changed = false;
+
+	/* remove rows that are gone, bottom up in contiguous runs */
+	for (int i = (int)items.count() - 1; i >= 0; i--) {
+		if (newRows.contains(items[i]))
+			continue;
+		int end = i;
+		while (i > 0 && !newRows.contains(items[i - 1]))
+			i--;
+		beginRemoveRows(QModelIndex(), i, end);
+		items.remove(i, end - i + 1);
+		endRemoveRows();
+		changed = true;
 	}
 
-	for (;;) {
-		int idx1Old = 0;
-		int idx1New = 0;
-		int count;
-		int i;
-
-		/* find first starting changed item index */
-		for (i = 0; i < newitems.count(); i++) {
-			obs_sceneitem_t *oldItem = items[i];
-			obs_sceneitem_t *newItem = newitems[i];
-			if (oldItem != newItem) {
-				idx1Old = i;
-				break;
-			}
-		}
-
-		/* if everything is the same, break */
-		if (i == newitems.count()) {
-			break;
-		}
-
-		/* find new starting index */
-		for (i = idx1Old + 1; i < newitems.count(); i++) {
-			obs_sceneitem_t *oldItem = items[idx1Old];
-			obs_sceneitem_t *newItem = newitems[i];
-
-			if (oldItem == newItem) {
-				idx1New = i;
-				break;
-			}
-		}
-
-		/* if item could not be found, do full reset */
-		if (i == newitems.count()) {
-			SceneChanged();
-			return;
-		}
-
-		/* get move count */
-		for (count = 1; (idx1New + count) < newitems.count(); count++) {
-			int oldIdx = idx1Old + count;
-			int newIdx = idx1New + count;
-
-			obs_sceneitem_t *oldItem = items[oldIdx];
-			obs_sceneitem_t *newItem = newitems[newIdx];
-
-			if (oldItem != newItem) {
-				break;
+	QHash<obs_sceneitem_t *, int> oldRows;
+	oldRows.reserve(items.count());
+	for (int i = 0; i < (int)items.count(); i++)
+		oldRows.insert(items[i], i);
+
+	std::vector<int> rows(count);
+	for (int k = 0; k < count; k++)
+		rows[k] = oldRows.value(newitems[k], -1);
+
+	for (const ReorderStep &step : PlanReorder(rows, (int)items.count())) {
+		if (step.insert) {
+			beginInsertRows(QModelIndex(), step.dest, step.dest + step.count - 1);
+			for (int i = 0; i < step.count; i++)
+				items.insert(step.dest + i, newitems[step.first + i]);
+			endInsertRows();
+
+			for (int i = 0; i < step.count; i++) {
+				QModelIndex index = createIndex(step.dest + i, 0);
+				st->UpdateWidget(index, newitems[step.first + i]);
+				if (obs_sceneitem_selected(newitems[step.first + i]))
+					st->selectionModel()->select(index, QItemSelectionModel::Select);
 			}
+			changed = true;
+		} else {
+			beginMoveRows(QModelIndex(), step.src, step.src + step.count - 1, QModelIndex(), step.dest);
+			MoveItems(items, step.src, step.count, step.dest);
+			endMoveRows();
 		}
+	}
 
-		/* move items */
-		beginMoveRows(QModelIndex(), idx1Old, idx1Old + count - 1, QModelIndex(), idx1New + count);
-		for (i = 0; i < count; i++) {
-			int to = idx1New + count;
-			if (to > idx1Old)
-				to--;
-			MoveItem(items, idx1Old, to);
-		}
-		endMoveRows();
+	if (changed) {
+		UpdateGroupState(true);
+		st->ConnectSceneSignals();
 	}
 }
 
@@ -809,14 +673,7 @@ void SourceTreeModel::Remove(obs_sceneitem_t *item)
 {
 	if (std::find(canvas_docks.begin(), canvas_docks.end(), st->canvasDock) == canvas_docks.end())
 		return;
-	int idx = -1;
-	for (int i = 0; i < items.count(); i++) {
-		if (items[i] == item) {
-			idx = i;
-			break;
-		}
-	}
-
+	int idx = Row(item);
 	if (idx == -1)
 		return;
 
@@ -842,8 +699,22 @@ void SourceTreeModel::Remove(obs_sceneitem_t *item)
 	items.remove(idx, endIdx - startIdx + 1);
 	endRemoveRows();
 
-	if (is_group)
+	if (is_group) {
 		UpdateGroupState(true);
+		st->ConnectSceneSignals();
+	}
+}
+
+int SourceTreeModel::Row(obs_sceneitem_t *item)
+{
+	if (rowsDirty) {
+		rows.clear();
+		rows.reserve(items.count());
+		for (int i = 0; i < items.count(); i++)
+			rows.insert(items[i], i);
+		rowsDirty = false;
+	}
+	return rows.value(item, -1);
 }
 
 OBSSceneItem SourceTreeModel::Get(int idx)
@@ -856,6 +727,13 @@ OBSSceneItem SourceTreeModel::Get(int idx)
 SourceTreeModel::SourceTreeModel(SourceTree *st_) : QAbstractListModel(st_), st(st_)
 {
 	obs_frontend_add_event_callback(OBSFrontendEvent, this);
+
+	auto markDirty = [this]() { rowsDirty = true; };
+	connect(this, &QAbstractItemModel::modelReset, this, markDirty);
+	connect(this, &QAbstractItemModel::rowsInserted, this, markDirty);
+	connect(this, &QAbstractItemModel::rowsRemoved, this, markDirty);
+	connect(this, &QAbstractItemModel::rowsMoved, this, markDirty);
+	connect(this, &QAbstractItemModel::layoutChanged, this, markDirty);
 }
 
 SourceTreeModel::~SourceTreeModel()
@@ -923,6 +801,7 @@ void SourceTreeModel::AddGroup()
 
 	st->UpdateWidget(createIndex(0, 0, nullptr), group);
 	UpdateGroupState(true);
+	st->ConnectSceneSignals();
 
 	QMetaObject::invokeMethod(st, "Edit", Qt::QueuedConnection, Q_ARG(int, 0));
 }
@@ -1065,6 +944,15 @@ SourceTree::SourceTree(CanvasDock *canvas_dock, QWidget *parent_) : QListView(pa
 	//connect(App(), &OBSApp::StyleChanged, this, &SourceTree::UpdateIcons);
 
 	setItemDelegate(new SourceTreeDelegate(this));
+
+	auto scheduleVisible = [this]() { ScheduleVisibleWidgets(); };
+	connect(stm_, &QAbstractItemModel::rowsInserted, this, scheduleVisible);
+	connect(stm_, &QAbstractItemModel::rowsRemoved, this, scheduleVisible);
+	connect(stm_, &QAbstractItemModel::rowsMoved, this, scheduleVisible);
+
+	signal_handler_t *sh = obs_get_signal_handler();
+	globalSigs.emplace_back(sh, "source_rename", sourceRenamed, this);
+	globalSigs.emplace_back(sh, "source_remove", sourceRemoved, this);
 }
 
 void SourceTree::UpdateIcons()
@@ -1081,11 +969,29 @@ void SourceTree::SetIconsVisible(bool visible)
 	stm->SceneChanged();
 }
 
+void SourceTree::SetVirtualized(bool enable)
+{
+	if (virtualized == enable)
+		return;
+
+	virtualized = enable;
+	liveRows.clear();
+	GetStm()->SceneChanged();
+}
+
 void SourceTree::ResetWidgets()
 {
 	SourceTreeModel *stm = GetStm();
 	stm->UpdateGroupState(false);
 
+	ConnectSceneSignals();
+
+	if (virtualized) {
+		liveRows.clear();
+		ScheduleVisibleWidgets();
+		return;
+	}
+
 	for (int i = 0; i < stm->items.count(); i++) {
 		QModelIndex index = stm->createIndex(i, 0, nullptr);
 		setIndexWidget(index, new SourceTreeItem(this, stm->items[i]));
@@ -1094,6 +1000,10 @@ void SourceTree::ResetWidgets()
 
 void SourceTree::UpdateWidget(const QModelIndex &idx, obs_sceneitem_t *item)
 {
+	if (virtualized) {
+		ScheduleVisibleWidgets();
+		return;
+	}
 	setIndexWidget(idx, new SourceTreeItem(this, item));
 }
 
@@ -1105,25 +1015,273 @@ void SourceTree::UpdateWidgets(bool force)
 		obs_sceneitem_t *item = stm->items[i];
 		SourceTreeItem *widget = GetItemWidget(i);
 
-		if (!widget) {
-			UpdateWidget(stm->createIndex(i, 0), item);
-		} else {
+		if (widget) {
 			widget->Update(force);
+		} else if (!virtualized) {
+			UpdateWidget(stm->createIndex(i, 0), item);
 		}
 	}
+
+	if (virtualized)
+		ScheduleVisibleWidgets();
 }
 
-void SourceTree::SelectItem(obs_sceneitem_t *sceneitem, bool select)
+/* ------------------------------------------------------------------------- */
+/* one set of scene and source signals per tree, routed to rows by item      */
+
+void SourceTree::sceneRemoved(void *data, calldata_t *)
 {
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	QMetaObject::invokeMethod(tree, "RefreshItems", Qt::QueuedConnection);
+}
+
+void SourceTree::sceneItemRemoved(void *data, calldata_t *cd)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+	obs_scene_t *scene = (obs_scene_t *)calldata_ptr(cd, "scene");
+
+	QMetaObject::invokeMethod(tree, "Remove", Q_ARG(OBSSceneItem, item), Q_ARG(OBSScene, scene));
+}
+
+void SourceTree::sceneItemVisible(void *data, calldata_t *cd)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+	bool visible = calldata_bool(cd, "visible");
+
+	QMetaObject::invokeMethod(
+		tree,
+		[tree, item, visible]() {
+			int row;
+			SourceTreeItem *widget = tree->GetRowWidget(item, row);
+			if (widget)
+				widget->VisibilityChanged(visible);
+			else if (row >= 0)
+				tree->update(tree->GetStm()->createIndex(row, 0));
+		},
+		Qt::QueuedConnection);
+}
+
+void SourceTree::sceneItemLocked(void *data, calldata_t *cd)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+	bool locked = calldata_bool(cd, "locked");
+
+	QMetaObject::invokeMethod(
+		tree,
+		[tree, item, locked]() {
+			int row;
+			SourceTreeItem *widget = tree->GetRowWidget(item, row);
+			if (widget)
+				widget->LockedChanged(locked);
+		},
+		Qt::QueuedConnection);
+}
+
+void SourceTree::sceneItemSelect(void *data, calldata_t *cd)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+
+	QMetaObject::invokeMethod(tree, [tree, item]() { tree->SelectItem(item, true); }, Qt::QueuedConnection);
+}
+
+void SourceTree::sceneItemDeselect(void *data, calldata_t *cd)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+
+	QMetaObject::invokeMethod(tree, [tree, item]() { tree->SelectItem(item, false); }, Qt::QueuedConnection);
+}
+
+void SourceTree::groupReordered(void *data, calldata_t *)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	QMetaObject::invokeMethod(tree, "ReorderItems", Qt::QueuedConnection);
+}
+
+void SourceTree::sourceRenamed(void *data, calldata_t *cd)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	obs_source_t *source = (obs_source_t *)calldata_ptr(cd, "source");
+	QString name = QString::fromUtf8(calldata_string(cd, "new_name"));
+
+	QMetaObject::invokeMethod(
+		tree,
+		[tree, source, name]() {
+			SourceTreeModel *stm = tree->GetStm();
+			for (int i = 0; i < stm->items.count(); i++) {
+				if (obs_sceneitem_get_source(stm->items[i]) != source)
+					continue;
+				SourceTreeItem *widget = tree->GetItemWidget(i);
+				if (widget)
+					widget->Renamed(name);
+				else
+					tree->update(stm->createIndex(i, 0));
+			}
+		},
+		Qt::QueuedConnection);
+}
+
+void SourceTree::sourceRemoved(void *data, calldata_t *cd)
+{
+	SourceTree *tree = reinterpret_cast<SourceTree *>(data);
+	obs_source_t *source = (obs_source_t *)calldata_ptr(cd, "source");
+
+	QMetaObject::invokeMethod(
+		tree,
+		[tree, source]() {
+			for (auto &item : tree->GetStm()->items) {
+				if (obs_sceneitem_get_source(item) == source) {
+					tree->RefreshItems();
+					return;
+				}
+			}
+		},
+		Qt::QueuedConnection);
+}
+
+SourceTreeItem *SourceTree::GetRowWidget(obs_sceneitem_t *item, int &row)
+{
+	row = GetStm()->Row(item);
+	return row >= 0 ? GetItemWidget(row) : nullptr;
+}
+
+void SourceTree::DisconnectSceneSignals()
+{
+	sceneSigs.clear();
+	sceneSigSources.clear();
+}
+
+void SourceTree::ConnectSceneSignals()
+{
+	std::vector<OBSSource> sources;
+	if (canvasDock->scene)
+		sources.emplace_back(obs_scene_get_source(canvasDock->scene));
+	for (auto &item : GetStm()->items) {
+		if (obs_sceneitem_is_group(item))
+			sources.emplace_back(obs_sceneitem_get_source(item));
+	}
+
+	/* same scene and groups as before, keep the existing connections */
+	if (sources == sceneSigSources)
+		return;
+
+	DisconnectSceneSignals();
+
+	/* hold the scenes so disconnecting never touches a destroyed signal handler */
+	sceneSigSources = std::move(sources);
+	for (size_t i = 0; i < sceneSigSources.size(); i++) {
+		signal_handler_t *signal = obs_source_get_signal_handler(sceneSigSources[i]);
+		sceneSigs.emplace_back(signal, "remove", sceneRemoved, this);
+		sceneSigs.emplace_back(signal, "item_remove", sceneItemRemoved, this);
+		sceneSigs.emplace_back(signal, "item_visible", sceneItemVisible, this);
+		sceneSigs.emplace_back(signal, "item_locked", sceneItemLocked, this);
+		sceneSigs.emplace_back(signal, "item_select", sceneItemSelect, this);
+		sceneSigs.emplace_back(signal, "item_deselect", sceneItemDeselect, this);
+		if (i > 0)
+			sceneSigs.emplace_back(signal, "reorder", groupReordered, this);
+	}
+}
+
+void SourceTree::ScheduleVisibleWidgets()
+{
+	if (!virtualized || visibleWidgetsPending)
+		return;
+	visibleWidgetsPending = true;
+	QMetaObject::invokeMethod(this, "UpdateVisibleWidgets", Qt::QueuedConnection);
+}
+
+SourceTreeItem *SourceTree::EnsureItemWidget(int idx)
+{
+	SourceTreeItem *widget = GetItemWidget(idx);
+	if (widget)
+		return widget;
+
 	SourceTreeModel *stm = GetStm();
-	int i = 0;
+	QModelIndex index = stm->createIndex(idx, 0);
+	widget = new SourceTreeItem(this, stm->items[idx]);
+	setIndexWidget(index, widget);
+	liveRows.append(index);
+	return widget;
+}
 
-	for (; i < stm->items.count(); i++) {
-		if (stm->items[i] == sceneitem)
-			break;
+/* only rows in or near the viewport carry a live SourceTreeItem, the rest are painted by the delegate */
+void SourceTree::UpdateVisibleWidgets()
+{
+	visibleWidgetsPending = false;
+	if (!virtualized)
+		return;
+
+	executeDelayedItemsLayout();
+
+	SourceTreeModel *stm = GetStm();
+	const int count = (int)stm->items.count();
+	if (!count) {
+		liveRows.clear();
+		return;
+	}
+
+	QModelIndex first = indexAt(QPoint(0, 0));
+	QModelIndex last = indexAt(QPoint(0, viewport()->height() - 1));
+	int firstRow = first.isValid() ? first.row() : 0;
+	int lastRow = last.isValid() ? last.row() : count - 1;
+
+	/* keep a page either side so short scrolls find their widgets ready */
+	const int page = lastRow - firstRow + 1;
+	firstRow = std::max(0, firstRow - page);
+	lastRow = std::min(count - 1, lastRow + page);
+
+	QList<QPersistentModelIndex> rows;
+	for (const QPersistentModelIndex &index : liveRows) {
+		if (!index.isValid())
+			continue;
+		SourceTreeItem *widget = GetItemWidget(index.row());
+		if (!widget)
+			continue;
+		if ((index.row() < firstRow || index.row() > lastRow) && !widget->IsEditing()) {
+			setIndexWidget(index, nullptr);
+			continue;
+		}
+		rows.append(index);
 	}
+	liveRows = rows;
+
+	bool relayout = false;
+	for (int i = firstRow; i <= lastRow; i++) {
+		if (GetItemWidget(i))
+			continue;
+		SourceTreeItem *widget = EnsureItemWidget(i);
+		const int height = widget->sizeHint().height();
+		if (height > rowHeight) {
+			rowHeight = height;
+			relayout = true;
+		}
+	}
+
+	if (relayout)
+		scheduleDelayedItemsLayout();
+}
 
-	if (i == stm->items.count())
+void SourceTree::resizeEvent(QResizeEvent *event)
+{
+	QListView::resizeEvent(event);
+	ScheduleVisibleWidgets();
+}
+
+void SourceTree::scrollContentsBy(int dx, int dy)
+{
+	QListView::scrollContentsBy(dx, dy);
+	ScheduleVisibleWidgets();
+}
+
+void SourceTree::SelectItem(obs_sceneitem_t *sceneitem, bool select)
+{
+	SourceTreeModel *stm = GetStm();
+	int i = stm->Row(sceneitem);
+	if (i < 0)
 		return;
 
 	QModelIndex index = stm->createIndex(i, 0);
@@ -1485,8 +1643,11 @@ bool SourceTree::Edit(int row)
 		return false;
 
 	QModelIndex index = stm->createIndex(row, 0);
-	QWidget *widget = indexWidget(index);
-	SourceTreeItem *itemWidget = reinterpret_cast<SourceTreeItem *>(widget);
+	if (virtualized)
+		scrollTo(index);
+	SourceTreeItem *itemWidget = virtualized ? EnsureItemWidget(row) : GetItemWidget(row);
+	if (!itemWidget)
+		return false;
 	if (itemWidget->IsEditing()) {
 #ifdef __APPLE__
 		itemWidget->ExitEditMode(true);
@@ -1655,8 +1816,48 @@ QSize SourceTreeDelegate::sizeHint(const QStyleOptionViewItem &option, const QMo
 	SourceTree *tree = qobject_cast<SourceTree *>(parent());
 	QWidget *item = tree->indexWidget(index);
 
-	if (!item)
-		return QStyledItemDelegate::sizeHint(option, index);
+	if (!item) {
+		QSize size = QStyledItemDelegate::sizeHint(option, index);
+		if (tree->virtualized)
+			size.setHeight(std::max(size.height(), tree->rowHeight > 0 ? tree->rowHeight : 24));
+		return size;
+	}
 
 	return (QSize(item->sizeHint()));
 }
+
+void SourceTreeDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	QStyledItemDelegate::paint(painter, option, index);
+
+	SourceTree *tree = qobject_cast<SourceTree *>(parent());
+	if (!tree->virtualized || tree->indexWidget(index))
+		return;
+
+	OBSSceneItem item = tree->Get(index.row());
+	obs_source_t *source = obs_sceneitem_get_source(item);
+	if (!source)
+		return;
+
+	const bool visible = obs_sceneitem_visible(item);
+	int indent = 3;
+	if (obs_sceneitem_is_group(item))
+		indent += 16;
+	else if (obs_sceneitem_get_scene(item) != tree->canvasDock->scene)
+		indent = 16;
+
+	QRect rect = option.rect.adjusted(indent, 0, 0, 0);
+	if (tree->iconsVisible) {
+		QRect iconRect(rect.left(), rect.center().y() - 8, 16, 16);
+		GetSourceIcon(source).paint(painter, iconRect, Qt::AlignCenter, visible ? QIcon::Normal : QIcon::Disabled);
+		rect.setLeft(iconRect.right() + 3);
+	}
+
+	const QPalette::ColorGroup group = visible ? QPalette::Normal : QPalette::Disabled;
+	const bool selected = option.state & QStyle::State_Selected;
+	painter->save();
+	painter->setPen(option.palette.color(group, selected ? QPalette::HighlightedText : QPalette::Text));
+	const QString name = QString::fromUtf8(obs_source_get_name(source));
+	painter->drawText(rect, Qt::AlignVCenter | Qt::AlignLeft, option.fontMetrics.elidedText(name, Qt::ElideRight, rect.width()));
+	painter->restore();
+}
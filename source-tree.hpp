@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QHash>
 #include <QList>
 #include <QVector>
 #include <QPointer>
@@ -52,9 +53,6 @@ class SourceTreeItem : public QFrame {
 		SubItem,
 	};
 
-	void DisconnectSignals();
-	void ReconnectSignals();
-
 	Type type = Type::Unknown;
 
 public:
@@ -77,24 +75,12 @@ private:
 
 	SourceTree *tree;
 	OBSSceneItem sceneitem;
-	std::vector<OBSSignal> sigs;
-	static void removeScene(void *data, calldata_t *cd);
-	static void removeItem(void *data, calldata_t *cd);
-	static void itemVisible(void *data, calldata_t *cd);
-	static void itemLocked(void *data, calldata_t *cd);
-	static void itemSelect(void *data, calldata_t *cd);
-	static void itemDeselect(void *data, calldata_t *cd);
-	static void reorderGroup(void *data, calldata_t *);
-	static void renamed(void *data, calldata_t *cd);
-	static void removeSource(void *data, calldata_t *);
 
 	virtual void paintEvent(QPaintEvent *event) override;
 
 	void ExitEditModeInternal(bool save);
 
 private slots:
-	void Clear();
-
 	void EnterEditMode();
 	void ExitEditMode(bool save);
 
@@ -103,9 +89,6 @@ private slots:
 	void Renamed(const QString &name);
 
 	void ExpandClicked(bool checked);
-
-	void Select();
-	void Deselect();
 };
 
 class SourceTreeModel : public QAbstractListModel {
@@ -117,6 +100,8 @@ class SourceTreeModel : public QAbstractListModel {
 
 	SourceTree *st;
 	QVector<OBSSceneItem> items;
+	QHash<obs_sceneitem_t *, int> rows;
+	bool rowsDirty = true;
 	bool hasGroups = false;
 
 	static void OBSFrontendEvent(enum obs_frontend_event event, void *ptr);
@@ -127,6 +112,7 @@ class SourceTreeModel : public QAbstractListModel {
 	void Add(obs_sceneitem_t *item);
 	void Remove(obs_sceneitem_t *item);
 	OBSSceneItem Get(int idx);
+	int Row(obs_sceneitem_t *item);
 	QString GetNewGroupName();
 	void AddGroup();
 
@@ -157,6 +143,7 @@ class SourceTree : public QListView {
 
 	friend class SourceTreeModel;
 	friend class SourceTreeItem;
+	friend class SourceTreeDelegate;
 	friend class CanvasDock;
 
 	bool textPrepared = false;
@@ -165,11 +152,35 @@ class SourceTree : public QListView {
 
 	bool iconsVisible = true;
 
+	bool virtualized = false;
+	bool visibleWidgetsPending = false;
+	int rowHeight = 0;
+	QList<QPersistentModelIndex> liveRows;
+	std::vector<OBSSource> sceneSigSources;
+	std::vector<OBSSignal> sceneSigs;
+
+	std::vector<OBSSignal> globalSigs;
+
+	static void sceneRemoved(void *data, calldata_t *cd);
+	static void sceneItemRemoved(void *data, calldata_t *cd);
+	static void sceneItemVisible(void *data, calldata_t *cd);
+	static void sceneItemLocked(void *data, calldata_t *cd);
+	static void sceneItemSelect(void *data, calldata_t *cd);
+	static void sceneItemDeselect(void *data, calldata_t *cd);
+	static void groupReordered(void *data, calldata_t *cd);
+	static void sourceRenamed(void *data, calldata_t *cd);
+	static void sourceRemoved(void *data, calldata_t *cd);
+
 	void UpdateNoSourcesMessage();
 
 	void ResetWidgets();
 	void UpdateWidget(const QModelIndex &idx, obs_sceneitem_t *item);
 	void UpdateWidgets(bool force = false);
+	void ConnectSceneSignals();
+	void DisconnectSceneSignals();
+	void ScheduleVisibleWidgets();
+	SourceTreeItem *EnsureItemWidget(int idx);
+	SourceTreeItem *GetRowWidget(obs_sceneitem_t *item, int &row);
 
 	inline SourceTreeModel *GetStm() const { return reinterpret_cast<SourceTreeModel *>(model()); }
 
@@ -198,6 +209,9 @@ public:
 	void UpdateIcons();
 	void SetIconsVisible(bool visible);
 
+	void SetVirtualized(bool enable);
+	inline bool IsVirtualized() const { return virtualized; }
+
 public slots:
 	inline void ReorderItems() { GetStm()->ReorderItems(); }
 	inline void RefreshItems() { GetStm()->SceneChanged(); }
@@ -207,11 +221,14 @@ public slots:
 	void AddGroup();
 	bool Edit(int idx);
 	void NewGroupEdit(int idx);
+	void UpdateVisibleWidgets();
 
 protected:
 	virtual void mouseDoubleClickEvent(QMouseEvent *event) override;
 	virtual void dropEvent(QDropEvent *event) override;
 	virtual void paintEvent(QPaintEvent *event) override;
+	virtual void resizeEvent(QResizeEvent *event) override;
+	virtual void scrollContentsBy(int dx, int dy) override;
 
 	virtual void selectionChanged(const QItemSelection &selected, const QItemSelection &deselected) override;
 };
@@ -222,4 +239,5 @@ class SourceTreeDelegate : public QStyledItemDelegate {
 public:
 	SourceTreeDelegate(QObject *parent);
 	virtual QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+	virtual void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 };
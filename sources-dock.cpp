@@ -197,6 +197,10 @@ void CanvasSourcesDock::ShowSourcesContextMenu(obs_sceneitem_t *item)
 {
 	auto menu = QMenu(this);
 	menu.addMenu(canvasDock->CreateAddSourcePopupMenu());
+	auto a = menu.addAction(QString::fromUtf8(obs_module_text("VirtualizedSourceList")),
+				[this](bool checked) { sourceList->SetVirtualized(checked); });
+	a->setCheckable(true);
+	a->setChecked(sourceList->IsVirtualized());
 	if (item) {
 		canvasDock->AddSceneItemMenuItems(&menu, item);
 	}
@@ -0,0 +1,171 @@
+/* opt-in benchmark for the per-frame cost of extra vertical canvases, configure the plugin with
+ * -DENABLE_CANVAS_BENCHMARK=ON. it needs an installed libobs with its graphics and image-source modules,
+ * and a display on linux:
+ *   canvas-scaling-benchmark [max canvases] [seconds per step] [plugin path] [plugin data path]
+ *
+ * every canvas is set up like a vertical canvas dock (own video at 1080x1920 with a scene on channel 0) and the
+ * average graphics thread frame time is sampled after each canvas is added */
+
+#include <obs.h>
+#include <util/platform.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+#include <obs-nix-platform.h>
+#include <X11/Xlib.h>
+#endif
+
+#define CANVAS_WIDTH 1080
+#define CANVAS_HEIGHT 1920
+
+struct BenchCanvas {
+	obs_canvas_t *canvas = nullptr;
+	obs_scene_t *scene = nullptr;
+	obs_source_t *color = nullptr;
+};
+
+static bool AddCanvas(std::vector<BenchCanvas> &canvases)
+{
+	BenchCanvas bc;
+	const std::string name = "Benchmark Vertical " + std::to_string(canvases.size() + 1);
+	bc.canvas = obs_canvas_create(name.c_str(), nullptr, DEVICE);
+	if (!bc.canvas)
+		return false;
+
+	obs_video_info ovi;
+	obs_get_video_info(&ovi);
+	ovi.base_width = CANVAS_WIDTH;
+	ovi.base_height = CANVAS_HEIGHT;
+	ovi.output_width = CANVAS_WIDTH;
+	ovi.output_height = CANVAS_HEIGHT;
+	if (!obs_canvas_reset_video(bc.canvas, &ovi)) {
+		obs_canvas_remove(bc.canvas);
+		obs_canvas_release(bc.canvas);
+		return false;
+	}
+
+	bc.scene = obs_canvas_scene_create(bc.canvas, (name + " Scene").c_str());
+	obs_data_t *settings = obs_data_create();
+	obs_data_set_int(settings, "width", CANVAS_WIDTH);
+	obs_data_set_int(settings, "height", CANVAS_HEIGHT);
+	obs_data_set_int(settings, "color", 0xFF00D299);
+	bc.color = obs_source_create("color_source_v3", (name + " Color").c_str(), settings, nullptr);
+	obs_data_release(settings);
+	if (bc.color)
+		obs_scene_add(bc.scene, bc.color);
+	obs_canvas_set_channel(bc.canvas, 0, obs_scene_get_source(bc.scene));
+	canvases.push_back(bc);
+	return true;
+}
+
+static void ReleaseCanvas(BenchCanvas &bc)
+{
+	obs_canvas_set_channel(bc.canvas, 0, nullptr);
+	obs_source_release(bc.color);
+	obs_scene_release(bc.scene);
+	obs_canvas_remove(bc.canvas);
+	obs_canvas_release(bc.canvas);
+}
+
+static double SampleFrameTimeMs(int seconds)
+{
+	/* let the frame time average settle on the new canvas count before reading it */
+	os_sleep_ms(1000);
+	double total = 0.0;
+	for (int i = 0; i < seconds; i++) {
+		os_sleep_ms(1000);
+		total += (double)obs_get_average_frame_time_ns() / 1000000.0;
+	}
+	return total / seconds;
+}
+
+int main(int argc, char **argv)
+{
+	const int max_canvases = argc > 1 ? atoi(argv[1]) : 8;
+	const int seconds = argc > 2 ? atoi(argv[2]) : 3;
+
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	Display *display = XOpenDisplay(nullptr);
+	if (!display) {
+		fprintf(stderr, "no X display available\n");
+		return 1;
+	}
+	obs_set_nix_platform(OBS_NIX_PLATFORM_X11_EGL);
+	obs_set_nix_platform_display(display);
+#endif
+
+	if (!obs_startup("en-US", nullptr, nullptr)) {
+		fprintf(stderr, "failed to start libobs\n");
+		return 1;
+	}
+
+	obs_video_info ovi = {};
+#ifdef _WIN32
+	ovi.graphics_module = "libobs-d3d11";
+#else
+	ovi.graphics_module = "libobs-opengl";
+#endif
+	ovi.fps_num = 60;
+	ovi.fps_den = 1;
+	ovi.base_width = 1920;
+	ovi.base_height = 1080;
+	ovi.output_width = 1920;
+	ovi.output_height = 1080;
+	ovi.output_format = VIDEO_FORMAT_NV12;
+	ovi.colorspace = VIDEO_CS_709;
+	ovi.range = VIDEO_RANGE_PARTIAL;
+	ovi.scale_type = OBS_SCALE_BICUBIC;
+	ovi.gpu_conversion = true;
+	if (obs_reset_video(&ovi) != OBS_VIDEO_SUCCESS) {
+		fprintf(stderr, "failed to reset video\n");
+		obs_shutdown();
+		return 1;
+	}
+
+	if (argc > 4)
+		obs_add_module_path(argv[3], argv[4]);
+	obs_load_all_modules();
+	obs_post_load_modules();
+
+	std::vector<BenchCanvas> canvases;
+	std::vector<double> frame_ms;
+	frame_ms.push_back(SampleFrameTimeMs(seconds));
+	printf("%8s %12s %14s\n", "canvases", "frame ms", "added ms");
+	printf("%8d %12.3f %14s\n", 0, frame_ms[0], "-");
+
+	int result = 0;
+	for (int n = 1; n <= max_canvases; n++) {
+		if (!AddCanvas(canvases)) {
+			fprintf(stderr, "failed to create canvas %d\n", n);
+			result = 1;
+			break;
+		}
+		frame_ms.push_back(SampleFrameTimeMs(seconds));
+		printf("%8d %12.3f %14.3f\n", n, frame_ms[n], frame_ms[n] - frame_ms[n - 1]);
+	}
+
+	/* linear means the last canvas costs about as much as the average canvas did */
+	const size_t added = frame_ms.size() - 1;
+	if (result == 0 && added >= 2) {
+		const double average = (frame_ms[added] - frame_ms[0]) / (double)added;
+		const double last = frame_ms[added] - frame_ms[added - 1];
+		printf("average per canvas %.3f ms, last canvas %.3f ms\n", average, last);
+		if (average > 0.0 && last > average * 1.5) {
+			fprintf(stderr, "per-frame cost grows faster than linear\n");
+			result = 1;
+		}
+	}
+
+	for (auto &bc : canvases)
+		ReleaseCanvas(bc);
+	canvases.clear();
+	obs_shutdown();
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	XCloseDisplay(display);
+#endif
+	return result;
+}
@@ -0,0 +1,118 @@
+/* standalone benchmark for the source tree reorder plan, no obs or qt needed:
+ *   c++ -O2 -std=c++17 -I.. reorder-benchmark.cpp -o reorder-benchmark
+ * or configure the plugin with -DENABLE_REORDER_BENCHMARK=ON */
+
+#include "source-tree-reorder.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/* same semantics as MoveItems in source-tree.cpp */
+static void MoveRows(std::vector<int> &rows, int src, int count, int dest)
+{
+	std::vector<int> moved(rows.begin() + src, rows.begin() + src + count);
+	rows.erase(rows.begin() + src, rows.begin() + src + count);
+	if (dest > src)
+		dest -= count;
+	rows.insert(rows.begin() + dest, moved.begin(), moved.end());
+}
+
+static size_t Apply(std::vector<int> &rows, const std::vector<int> &order)
+{
+	std::vector<int> where(order.size() * 2 + rows.size(), -1);
+	for (int i = 0; i < (int)rows.size(); i++)
+		where[rows[i]] = i;
+
+	std::vector<int> oldRows(order.size());
+	for (size_t k = 0; k < order.size(); k++)
+		oldRows[k] = where[order[k]];
+
+	auto steps = PlanReorder(oldRows, (int)rows.size());
+	for (auto &step : steps) {
+		if (step.insert)
+			rows.insert(rows.begin() + step.dest, order.begin() + step.first,
+				    order.begin() + step.first + step.count);
+		else
+			MoveRows(rows, step.src, step.count, step.dest);
+	}
+	return steps.size();
+}
+
+struct Scenario {
+	const char *name;
+	void (*make)(std::mt19937 &rng, int n, std::vector<int> &rows, std::vector<int> &order);
+};
+
+static void MakeShuffle(std::mt19937 &rng, int n, std::vector<int> &rows, std::vector<int> &order)
+{
+	rows.resize(n);
+	std::iota(rows.begin(), rows.end(), 0);
+	order = rows;
+	std::shuffle(order.begin(), order.end(), rng);
+}
+
+static void MakeReverse(std::mt19937 &, int n, std::vector<int> &rows, std::vector<int> &order)
+{
+	rows.resize(n);
+	std::iota(rows.begin(), rows.end(), 0);
+	order.assign(rows.rbegin(), rows.rend());
+}
+
+static void MakeMoveOne(std::mt19937 &rng, int n, std::vector<int> &rows, std::vector<int> &order)
+{
+	rows.resize(n);
+	std::iota(rows.begin(), rows.end(), 0);
+	order = rows;
+	std::uniform_int_distribution<int> pick(0, n - 1);
+	MoveRows(order, pick(rng), 1, pick(rng));
+}
+
+static void MakeInsert(std::mt19937 &rng, int n, std::vector<int> &rows, std::vector<int> &order)
+{
+	rows.resize(n);
+	std::iota(rows.begin(), rows.end(), 0);
+	order = rows;
+	std::uniform_int_distribution<int> pick(0, n);
+	for (int i = 0; i < n / 10 + 1; i++)
+		order.insert(order.begin() + pick(rng), n + i);
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 200;
+	const int sizes[] = {10, 50, 100, 500, 1000};
+	const Scenario scenarios[] = {
+		{"shuffle", MakeShuffle},
+		{"reverse", MakeReverse},
+		{"move one", MakeMoveOne},
+		{"insert 10%", MakeInsert},
+	};
+
+	std::mt19937 rng(1234);
+	printf("%-12s %6s %10s %12s\n", "scenario", "rows", "steps", "us/reorder");
+	for (auto &scenario : scenarios) {
+		for (int n : sizes) {
+			size_t steps = 0;
+			double total = 0.0;
+			for (int i = 0; i < iterations; i++) {
+				std::vector<int> rows, order;
+				scenario.make(rng, n, rows, order);
+
+				auto start = std::chrono::steady_clock::now();
+				steps += Apply(rows, order);
+				total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+				if (rows != order) {
+					fprintf(stderr, "%s with %d rows did not reach the new order\n", scenario.name, n);
+					return 1;
+				}
+			}
+			printf("%-12s %6d %10.1f %12.2f\n", scenario.name, n, (double)steps / iterations, total / iterations);
+		}
+	}
+	return 0;
+}
@@ -1,6 +1,8 @@
 #include "vertical-canvas.hpp"
 
+#include <algorithm>
 #include <list>
+#include <random>
 
 #include "version.h"
 
@@ -16,24 +18,32 @@
 #include <QMessageBox>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPainterPath>
 #include <QPushButton>
+#include <QThread>
 #include <QTimer>
 #include <QToolBar>
 #include <QWidgetAction>
 
 #include "audio-wrapper-source.h"
 #include "config-dialog.hpp"
+#include "derived-canvas-source.h"
 #include "display-helpers.hpp"
 #include "media-io/video-frame.h"
 #include "multi-canvas-source.h"
 #include "name-dialog.hpp"
 #include "obs-websocket-api.h"
+#ifdef ENABLE_REMUX_QUEUE
+#include "remux-queue.h"
+#endif
 #include "scenes-dock.hpp"
+#include "source-index.h"
 #include "sources-dock.hpp"
 #include "transitions-dock.hpp"
 #include "util/config-file.h"
 #include "util/dstr.h"
 #include "util/platform.h"
+#include "util/profiler.h"
 #include "util/util.hpp"
 extern "C" {
 #include "file-updater.h"
@@ -53,7 +63,16 @@ OBS_MODULE_USE_DEFAULT_LOCALE("vertical-canvas", "en-US")
 
 #define SPACER_LABEL_MARGIN 6.0f
 
+#define THUMBNAIL_HEIGHT 128
+#define THUMBNAIL_MIN_INTERVAL_NS 100000000ULL
+#define THUMBNAIL_BUDGET_DIVISOR 50
+
 #define CANVAS_NAME "Aitum Vertical"
+#define DISK_BACKTRACK_SEGMENT_SEC 10
+#define REPLAY_SAVE_TIMEOUT_MS 60000
+#define STREAM_FIRST_PACKET_POLL_MS 100
+#define SCENE_PREWARM_DWELL_MS 200
+#define SCENE_PREWARM_MAX 3
 
 inline std::list<CanvasDock *> canvas_docks;
 
@@ -123,9 +142,17 @@ static void save_canvas()
 	bfree(path);
 }
 
-void transition_start(void *, calldata_t *)
+void transition_start(void *, calldata_t *cd)
 {
+	const uint64_t start = os_gettime_ns();
+	const uint64_t frame_time = obs_get_video_frame_time();
+	auto transition = (obs_source_t *)calldata_ptr(cd, "source");
 	for (const auto &it : canvas_docks) {
+		// the main transition is started from the UI thread, so the linked scene can be switched before the
+		// next graphics tick instead of after a round trip through the event loop
+		if (transition && QThread::currentThread() == it->thread()) {
+			it->MainTransitionStarted(transition, start, frame_time);
+		}
 		QMetaObject::invokeMethod(it, "MainSceneChanged", Qt::QueuedConnection);
 	}
 }
@@ -231,10 +258,11 @@ void frontend_event(obs_frontend_event event, void *private_data)
 static void get_video(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		calldata_set_ptr(cd, "video", it->GetVideo());
@@ -242,13 +270,31 @@ static void get_video(void *data, calldata_t *cd)
 	}
 }
 
+static void get_derived_video(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
+	const auto width = calldata_int(cd, "width");
+	const auto height = calldata_int(cd, "height");
+	const auto derived_width = (uint32_t)calldata_int(cd, "derived_width");
+	const auto derived_height = (uint32_t)calldata_int(cd, "derived_height");
+	for (const auto &it : canvas_docks) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
+			continue;
+		}
+		calldata_set_ptr(cd, "video", it->GetDerivedVideo(derived_width, derived_height));
+		return;
+	}
+}
+
 static void get_stream_settings(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		it->DisableStreamSettings();
@@ -260,10 +306,11 @@ static void get_stream_settings(void *data, calldata_t *cd)
 static void set_stream_settings(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		obs_data_array_t *outputs = (obs_data_array_t *)calldata_ptr(cd, "outputs");
@@ -279,10 +326,11 @@ static void set_stream_settings(void *data, calldata_t *cd)
 static void start_stream_output(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		auto name = calldata_string(cd, "name");
@@ -294,10 +342,11 @@ static void start_stream_output(void *data, calldata_t *cd)
 static void stop_stream_output(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		auto name = calldata_string(cd, "name");
@@ -309,10 +358,11 @@ static void stop_stream_output(void *data, calldata_t *cd)
 static void get_stream_output(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		auto name = calldata_string(cd, "name");
@@ -321,13 +371,29 @@ static void get_stream_output(void *data, calldata_t *cd)
 	}
 }
 
+static void get_stats(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
+	const auto width = calldata_int(cd, "width");
+	const auto height = calldata_int(cd, "height");
+	for (const auto &it : canvas_docks) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
+			continue;
+		}
+		calldata_set_ptr(cd, "stats", it->GetStats());
+		return;
+	}
+}
+
 static void add_chapter(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		auto output = it->GetRecordOutput();
@@ -349,10 +415,11 @@ static void add_chapter(void *data, calldata_t *cd)
 static void get_scene(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		calldata_set_string(cd, "scene", it->GetScene().toUtf8().constData());
@@ -363,17 +430,41 @@ static void get_scene(void *data, calldata_t *cd)
 static void switch_scene(void *data, calldata_t *cd)
 {
 	UNUSED_PARAMETER(data);
+	const auto canvas_uuid = calldata_string(cd, "canvas_uuid");
 	const auto width = calldata_int(cd, "width");
 	const auto height = calldata_int(cd, "height");
 	QString scene = QString::fromUtf8(calldata_string(cd, "scene"));
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		QMetaObject::invokeMethod(it, "SwitchScene", Q_ARG(QString, scene));
 	}
 }
 
+static obs_data_array_t *get_canvas_list()
+{
+	auto ca = obs_data_array_create();
+	for (const auto &it : canvas_docks) {
+		auto c = obs_data_create();
+		auto uuid = it->GetCanvasUuid();
+		obs_data_set_string(c, "canvas_uuid", uuid ? uuid : "");
+		obs_data_set_string(c, "canvas_name", it->GetCanvasName().c_str());
+		obs_data_set_string(c, "dock_id", it->GetDockId().c_str());
+		obs_data_set_int(c, "width", it->GetCanvasWidth());
+		obs_data_set_int(c, "height", it->GetCanvasHeight());
+		obs_data_array_push_back(ca, c);
+		obs_data_release(c);
+	}
+	return ca;
+}
+
+static void get_canvases(void *data, calldata_t *cd)
+{
+	UNUSED_PARAMETER(data);
+	calldata_set_ptr(cd, "canvases", get_canvas_list());
+}
+
 obs_websocket_vendor vendor = nullptr;
 
 void vendor_request_version(obs_data_t *request_data, obs_data_t *response_data, void *)
@@ -383,6 +474,15 @@ void vendor_request_version(obs_data_t *request_data, obs_data_t *response_data,
 	obs_data_set_bool(response_data, "success", true);
 }
 
+void vendor_request_get_canvases(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	UNUSED_PARAMETER(request_data);
+	auto ca = get_canvas_list();
+	obs_data_set_array(response_data, "canvases", ca);
+	obs_data_array_release(ca);
+	obs_data_set_bool(response_data, "success", true);
+}
+
 void vendor_request_switch_scene(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
 	const char *scene_name = obs_data_get_string(request_data, "scene");
@@ -391,19 +491,47 @@ void vendor_request_switch_scene(obs_data_t *request_data, obs_data_t *response_
 		obs_data_set_bool(response_data, "success", false);
 		return;
 	}
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
+	const auto width = obs_data_get_int(request_data, "width");
+	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
+			continue;
+		}
 		QMetaObject::invokeMethod(it, "SwitchScene", Q_ARG(QString, QString::fromUtf8(scene_name)));
 	}
 
 	obs_data_set_bool(response_data, "success", true);
 }
 
+void vendor_request_prewarm_scene(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	const char *scene_name = obs_data_get_string(request_data, "scene");
+	if (!scene_name || !strlen(scene_name)) {
+		obs_data_set_string(response_data, "error", "'scene' not set");
+		obs_data_set_bool(response_data, "success", false);
+		return;
+	}
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
+	const auto width = obs_data_get_int(request_data, "width");
+	const auto height = obs_data_get_int(request_data, "height");
+	for (const auto &it : canvas_docks) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
+			continue;
+		}
+		QMetaObject::invokeMethod(it, "PrewarmScene", Q_ARG(QString, QString::fromUtf8(scene_name)));
+	}
+
+	obs_data_set_bool(response_data, "success", true);
+}
+
 void vendor_request_current_scene(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		auto scene = obs_scene_get_source(it->GetCurrentScene());
@@ -420,11 +548,12 @@ void vendor_request_current_scene(obs_data_t *request_data, obs_data_t *response
 
 void vendor_request_get_scenes(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	auto sa = obs_data_array_create();
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		auto scenes = it->GetScenes();
@@ -442,14 +571,22 @@ void vendor_request_get_scenes(obs_data_t *request_data, obs_data_t *response_da
 
 void vendor_request_status(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		obs_data_set_bool(response_data, "streaming", it->StreamingActive());
+		obs_data_set_bool(response_data, "streaming_armed", it->StreamArmed());
+		auto stream_outputs = it->GetStreamStats();
+		obs_data_set_array(response_data, "stream_outputs", stream_outputs);
+		obs_data_array_release(stream_outputs);
 		obs_data_set_bool(response_data, "recording", it->RecordingActive());
+		auto record_stats = it->GetRecordStats();
+		obs_data_set_obj(response_data, "record_stats", record_stats);
+		obs_data_release(record_stats);
 		obs_data_set_bool(response_data, "backtrack", it->BacktrackActive());
 		obs_data_set_bool(response_data, "virtual_camera", it->VirtualCameraActive());
 		obs_data_set_bool(response_data, "success", true);
@@ -458,13 +595,32 @@ void vendor_request_status(obs_data_t *request_data, obs_data_t *response_data,
 	obs_data_set_bool(response_data, "success", false);
 }
 
+void vendor_request_get_stats(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
+	const auto width = obs_data_get_int(request_data, "width");
+	const auto height = obs_data_get_int(request_data, "height");
+	for (const auto &it : canvas_docks) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
+			continue;
+		}
+		auto stats = it->GetStats();
+		obs_data_set_obj(response_data, "stats", stats);
+		obs_data_release(stats);
+		obs_data_set_bool(response_data, "success", true);
+		return;
+	}
+	obs_data_set_bool(response_data, "success", false);
+}
+
 void vendor_request_invoke(obs_data_t *request_data, obs_data_t *response_data, void *p)
 {
 	const char *method = static_cast<char *>(p);
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 		QMetaObject::invokeMethod(it, method);
@@ -477,14 +633,16 @@ void vendor_request_invoke(obs_data_t *request_data, obs_data_t *response_data,
 void vendor_request_save_replay(obs_data_t *request_data, obs_data_t *response_data, void *p)
 {
 	UNUSED_PARAMETER(p);
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
-		QMetaObject::invokeMethod(it, "ReplayButtonClicked",
-					  Q_ARG(QString, QString::fromUtf8(obs_data_get_string(request_data, "filename"))));
+		QMetaObject::invokeMethod(it, "SaveBacktrack",
+					  Q_ARG(QString, QString::fromUtf8(obs_data_get_string(request_data, "filename"))),
+					  Q_ARG(int, (int)obs_data_get_int(request_data, "seconds")));
 		obs_data_set_bool(response_data, "success", true);
 		return;
 	}
@@ -495,6 +653,7 @@ void vendor_request_update_stream_key(obs_data_t *request_data, obs_data_t *resp
 {
 	// Parse request_data to get the new stream_key
 	const char *new_stream_key = obs_data_get_string(request_data, "stream_key");
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 
@@ -506,7 +665,7 @@ void vendor_request_update_stream_key(obs_data_t *request_data, obs_data_t *resp
 
 	// Loop through each CanvasDock to find the right one
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 
@@ -524,6 +683,7 @@ void vendor_request_update_stream_server(obs_data_t *request_data, obs_data_t *r
 {
 	// Parse request_data to get the new stream_server
 	const char *new_stream_server = obs_data_get_string(request_data, "stream_server");
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 
@@ -535,7 +695,7 @@ void vendor_request_update_stream_server(obs_data_t *request_data, obs_data_t *r
 
 	// Loop through each CanvasDock to find the right one
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 
@@ -552,10 +712,11 @@ void vendor_request_update_stream_server(obs_data_t *request_data, obs_data_t *r
 
 void vendor_request_add_chapter(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 
@@ -580,10 +741,11 @@ void vendor_request_add_chapter(obs_data_t *request_data, obs_data_t *response_d
 
 void vendor_request_pause_recording(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 
@@ -601,10 +763,11 @@ void vendor_request_pause_recording(obs_data_t *request_data, obs_data_t *respon
 
 void vendor_request_unpause_recording(obs_data_t *request_data, obs_data_t *response_data, void *)
 {
+	const auto canvas_uuid = obs_data_get_string(request_data, "canvas_uuid");
 	const auto width = obs_data_get_int(request_data, "width");
 	const auto height = obs_data_get_int(request_data, "height");
 	for (const auto &it : canvas_docks) {
-		if ((width && it->GetCanvasWidth() != width) || (height && it->GetCanvasHeight() != height)) {
+		if (!it->MatchesCanvas(canvas_uuid, width, height)) {
 			continue;
 		}
 
@@ -650,28 +813,95 @@ bool obs_module_load(void)
 
 	obs_register_source(&audio_wrapper_source);
 	obs_register_source(&multi_canvas_source);
+	obs_register_source(&derived_canvas_source);
+
+	source_index_init();
 
 	auto ph = obs_get_proc_handler();
-	proc_handler_add(ph, "void aitum_vertical_get_video(in int width, in int height, out ptr video)", get_video, nullptr);
-	proc_handler_add(ph, "void aitum_vertical_get_stream_settings(in int width, in int height, out ptr outputs)",
-			 get_stream_settings, nullptr);
-	proc_handler_add(ph, "void aitum_vertical_set_stream_settings(in int width, in int height, in ptr outputs)",
-			 set_stream_settings, nullptr);
-	proc_handler_add(ph, "void aitum_vertical_get_stream_output(in int width, in int height, in string name, out ptr output)",
-			 get_stream_output, nullptr);
-	proc_handler_add(ph, "void aitum_vertical_start_stream_output(in int width, in int height, in string name)",
-			 start_stream_output, nullptr);
-	proc_handler_add(ph, "void aitum_vertical_stop_stream_output(in int width, in int height, in string name)",
-			 stop_stream_output, nullptr);
-	proc_handler_add(ph, "void aitum_vertical_add_chapter(in int width, in int height, in string chapter_name)", add_chapter,
-			 nullptr);
-	proc_handler_add(ph, "void aitum_vertical_get_scene(in int width, in int height, out string scene)", get_scene, nullptr);
-	proc_handler_add(ph, "void aitum_vertical_switch_scene(in int width, in int height, in string scene)", switch_scene,
-			 nullptr);
+	proc_handler_add(ph, "void aitum_vertical_get_canvases(out ptr canvases)", get_canvases, nullptr);
+	proc_handler_add(ph, "void aitum_vertical_get_video(in string canvas_uuid, in int width, in int height, out ptr video)",
+			 get_video, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_get_derived_video(in string canvas_uuid, in int width, in int height, in int derived_width, in int derived_height, out ptr video)",
+		get_derived_video, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_get_stream_settings(in string canvas_uuid, in int width, in int height, out ptr outputs)",
+		get_stream_settings, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_set_stream_settings(in string canvas_uuid, in int width, in int height, in ptr outputs)",
+		set_stream_settings, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_get_stream_output(in string canvas_uuid, in int width, in int height, in string name, out ptr output)",
+		get_stream_output, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_start_stream_output(in string canvas_uuid, in int width, in int height, in string name)",
+		start_stream_output, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_stop_stream_output(in string canvas_uuid, in int width, in int height, in string name)",
+		stop_stream_output, nullptr);
+	proc_handler_add(ph, "void aitum_vertical_get_stats(in string canvas_uuid, in int width, in int height, out ptr stats)",
+			 get_stats, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_add_chapter(in string canvas_uuid, in int width, in int height, in string chapter_name)",
+		add_chapter, nullptr);
+	proc_handler_add(ph, "void aitum_vertical_get_scene(in string canvas_uuid, in int width, in int height, out string scene)",
+			 get_scene, nullptr);
+	proc_handler_add(
+		ph,
+		"void aitum_vertical_switch_scene(in string canvas_uuid, in int width, in int height, in string scene)",
+		switch_scene, nullptr);
 
 	return true;
 }
 
+static void ensure_unique_canvas(obs_data_t *item)
+{
+	std::string dock_id = obs_data_get_string(item, "dock_id");
+	std::string canvas_name = obs_data_get_string(item, "canvas_name");
+	bool unique = !dock_id.empty() && !canvas_name.empty();
+	for (const auto &it : canvas_docks) {
+		if (it->GetDockId() == dock_id || it->GetCanvasName() == canvas_name) {
+			unique = false;
+		}
+	}
+	if (unique) {
+		if (!strlen(obs_data_get_string(item, "title"))) {
+			obs_data_set_string(item, "title", obs_module_text("Vertical"));
+		}
+		return;
+	}
+	for (size_t n = 1;; n++) {
+		dock_id = "VerticalCanvasDock";
+		canvas_name = CANVAS_NAME;
+		std::string title = obs_module_text("Vertical");
+		if (n > 1) {
+			dock_id += std::to_string(n);
+			canvas_name += " " + std::to_string(n);
+			title += " " + std::to_string(n);
+		}
+		bool taken = false;
+		for (const auto &it : canvas_docks) {
+			if (it->GetDockId() == dock_id || it->GetCanvasName() == canvas_name) {
+				taken = true;
+			}
+		}
+		if (taken) {
+			continue;
+		}
+		obs_data_set_string(item, "dock_id", dock_id.c_str());
+		obs_data_set_string(item, "canvas_name", canvas_name.c_str());
+		obs_data_set_string(item, "title", title.c_str());
+		return;
+	}
+}
+
 void obs_module_post_load(void)
 {
 	const auto path = obs_module_config_path("config.json");
@@ -695,8 +925,7 @@ void obs_module_post_load(void)
 	if (!count) {
 		const auto canvasDock = new CanvasDock(nullptr, main_window);
 		const QString title = QString::fromUtf8(obs_module_text("Vertical"));
-		const auto name = "VerticalCanvasDock";
-		obs_frontend_add_dock_by_id(name, title.toUtf8().constData(), canvasDock);
+		obs_frontend_add_dock_by_id(canvasDock->GetDockId().c_str(), title.toUtf8().constData(), canvasDock);
 		canvas_docks.push_back(canvasDock);
 		obs_data_array_release(canvas);
 		blog(LOG_INFO, "[Vertical Canvas] New Canvas created");
@@ -704,10 +933,10 @@ void obs_module_post_load(void)
 	}
 	for (size_t i = 0; i < count; i++) {
 		const auto item = obs_data_array_item(canvas, i);
+		ensure_unique_canvas(item);
 		const auto canvasDock = new CanvasDock(item, main_window);
-		const QString title = QString::fromUtf8(obs_module_text("Vertical"));
-		const auto name = "VerticalCanvasDock";
-		obs_frontend_add_dock_by_id(name, title.toUtf8().constData(), canvasDock);
+		const QString title = QString::fromUtf8(obs_data_get_string(item, "title"));
+		obs_frontend_add_dock_by_id(canvasDock->GetDockId().c_str(), title.toUtf8().constData(), canvasDock);
 		obs_data_release(item);
 		canvas_docks.push_back(canvasDock);
 	}
@@ -720,13 +949,18 @@ void obs_module_post_load(void)
 		return;
 	}
 	obs_websocket_vendor_register_request(vendor, "version", vendor_request_version, nullptr);
+	obs_websocket_vendor_register_request(vendor, "get_canvases", vendor_request_get_canvases, nullptr);
 	obs_websocket_vendor_register_request(vendor, "switch_scene", vendor_request_switch_scene, nullptr);
+	obs_websocket_vendor_register_request(vendor, "prewarm_scene", vendor_request_prewarm_scene, nullptr);
 	obs_websocket_vendor_register_request(vendor, "current_scene", vendor_request_current_scene, nullptr);
 	obs_websocket_vendor_register_request(vendor, "get_scenes", vendor_request_get_scenes, nullptr);
 	obs_websocket_vendor_register_request(vendor, "status", vendor_request_status, nullptr);
+	obs_websocket_vendor_register_request(vendor, "get_stats", vendor_request_get_stats, nullptr);
 	obs_websocket_vendor_register_request(vendor, "start_streaming", vendor_request_invoke, (void *)"StartStream");
 	obs_websocket_vendor_register_request(vendor, "stop_streaming", vendor_request_invoke, (void *)"StopStream");
 	obs_websocket_vendor_register_request(vendor, "toggle_streaming", vendor_request_invoke, (void *)"StreamButtonClicked");
+	obs_websocket_vendor_register_request(vendor, "arm_streaming", vendor_request_invoke, (void *)"ArmStream");
+	obs_websocket_vendor_register_request(vendor, "disarm_streaming", vendor_request_invoke, (void *)"DisarmStream");
 	obs_websocket_vendor_register_request(vendor, "start_recording", vendor_request_invoke, (void *)"StartRecord");
 	obs_websocket_vendor_register_request(vendor, "stop_recording", vendor_request_invoke, (void *)"StopRecord");
 	obs_websocket_vendor_register_request(vendor, "toggle_recording", vendor_request_invoke, (void *)"RecordButtonClicked");
@@ -755,13 +989,18 @@ void obs_module_unload(void)
 {
 	if (vendor && obs_get_module("obs-websocket")) {
 		obs_websocket_vendor_unregister_request(vendor, "version");
+		obs_websocket_vendor_unregister_request(vendor, "get_canvases");
 		obs_websocket_vendor_unregister_request(vendor, "switch_scene");
+		obs_websocket_vendor_unregister_request(vendor, "prewarm_scene");
 		obs_websocket_vendor_unregister_request(vendor, "current_scene");
 		obs_websocket_vendor_unregister_request(vendor, "get_scenes");
 		obs_websocket_vendor_unregister_request(vendor, "status");
+		obs_websocket_vendor_unregister_request(vendor, "get_stats");
 		obs_websocket_vendor_unregister_request(vendor, "start_streaming");
 		obs_websocket_vendor_unregister_request(vendor, "stop_streaming");
 		obs_websocket_vendor_unregister_request(vendor, "toggle_streaming");
+		obs_websocket_vendor_unregister_request(vendor, "arm_streaming");
+		obs_websocket_vendor_unregister_request(vendor, "disarm_streaming");
 		obs_websocket_vendor_unregister_request(vendor, "start_recording");
 		obs_websocket_vendor_unregister_request(vendor, "stop_recording");
 		obs_websocket_vendor_unregister_request(vendor, "toggle_recording");
@@ -778,6 +1017,11 @@ void obs_module_unload(void)
 		update_info_destroy(version_update_info);
 		version_update_info = nullptr;
 	}
+#ifdef ENABLE_REMUX_QUEUE
+	remux_queue_free();
+#endif
+	backtrack_ring_shutdown();
+	source_index_free();
 }
 
 MODULE_EXPORT const char *obs_module_description(void)
@@ -795,6 +1039,143 @@ CanvasScenesDock *CanvasDock::GetScenesDock()
 	return scenesDock;
 }
 
+#define PREWARM_SCENE_HOTKEY "VerticalCanvas.PrewarmScene"
+
+void CanvasDock::RegisterSceneHotkeys(obs_source_t *scene)
+{
+	struct find_hotkeys {
+		obs_source_t *source;
+		bool select = false;
+		bool prewarm = false;
+	};
+	find_hotkeys f = {scene};
+
+	obs_enum_hotkeys(
+		[](void *param, obs_hotkey_id id, obs_hotkey_t *key) {
+			UNUSED_PARAMETER(id);
+			auto f = (find_hotkeys *)param;
+			if (obs_hotkey_get_registerer_type(key) != OBS_HOTKEY_REGISTERER_SOURCE) {
+				return true;
+			}
+			auto potential_source = (obs_weak_source_t *)obs_hotkey_get_registerer(key);
+			if (obs_hotkey_get_registerer(key) != f->source &&
+			    !obs_weak_source_references_source(potential_source, f->source)) {
+				return true;
+			}
+			if (strcmp("OBSBasic.SelectScene", obs_hotkey_get_name(key)) == 0) {
+				f->select = true;
+			} else if (strcmp(PREWARM_SCENE_HOTKEY, obs_hotkey_get_name(key)) == 0) {
+				f->prewarm = true;
+			}
+			return !f->select || !f->prewarm;
+		},
+		&f);
+
+	if (!f.select) {
+		std::string ssn = obs_canvas_get_name(canvas);
+		ssn += " ";
+		ssn += obs_frontend_get_locale_string("Basic.Hotkeys.SelectScene");
+		obs_hotkey_register_source(
+			scene, "OBSBasic.SelectScene", ssn.c_str(),
+			[](void *data, obs_hotkey_id, obs_hotkey_t *key, bool pressed) {
+				if (!pressed) {
+					return;
+				}
+				auto p = (CanvasDock *)data;
+				auto potential_source = (obs_weak_source_t *)obs_hotkey_get_registerer(key);
+				OBSSourceAutoRelease source = obs_weak_source_get_source(potential_source);
+				if (source) {
+					auto sn = QString::fromUtf8(obs_source_get_name(source));
+					QMetaObject::invokeMethod(p, "SwitchScene", Q_ARG(QString, sn), Q_ARG(bool, true));
+				}
+			},
+			this);
+	}
+	if (!f.prewarm) {
+		std::string ssn = obs_canvas_get_name(canvas);
+		ssn += " ";
+		ssn += obs_module_text("PrewarmScene");
+		obs_hotkey_register_source(
+			scene, PREWARM_SCENE_HOTKEY, ssn.c_str(),
+			[](void *data, obs_hotkey_id, obs_hotkey_t *key, bool pressed) {
+				if (!pressed) {
+					return;
+				}
+				auto p = (CanvasDock *)data;
+				auto potential_source = (obs_weak_source_t *)obs_hotkey_get_registerer(key);
+				OBSSourceAutoRelease source = obs_weak_source_get_source(potential_source);
+				if (source) {
+					auto sn = QString::fromUtf8(obs_source_get_name(source));
+					QMetaObject::invokeMethod(p, "PrewarmScene", Q_ARG(QString, sn));
+				}
+			},
+			this);
+	}
+}
+
+// keeps a scene showing for a short while before it is switched to, so its sources are already running when the
+// transition starts
+void CanvasDock::PrewarmSource(obs_source_t *scene_source)
+{
+	if (!scene_source || scene_prewarm_ttl_ms <= 0 || scene_source == obs_scene_get_source(scene)) {
+		return;
+	}
+	const uint64_t expires = os_gettime_ns() + (uint64_t)scene_prewarm_ttl_ms * 1000000ULL;
+	const std::string uuid = obs_source_get_uuid(scene_source);
+	auto it = prewarmedScenes.find(uuid);
+	if (it != prewarmedScenes.end()) {
+		it->second.expires = expires;
+		return;
+	}
+	if (prewarmedScenes.size() >= SCENE_PREWARM_MAX) {
+		// only a few scenes are kept showing at once, the one closest to expiring makes room
+		auto oldest = std::min_element(prewarmedScenes.begin(), prewarmedScenes.end(),
+					       [](const auto &a, const auto &b) { return a.second.expires < b.second.expires; });
+		obs_source_dec_showing(oldest->second.source);
+		prewarmedScenes.erase(oldest);
+	}
+	obs_source_inc_showing(scene_source);
+	prewarmedScenes.emplace(uuid, PrewarmedScene{OBSSource(scene_source), expires});
+	if (!prewarmTimer.isActive()) {
+		prewarmTimer.start(250);
+	}
+}
+
+// hovering only prewarms a scene once the pointer rests on it, so sweeping over the list starts nothing
+void CanvasDock::HoverPrewarmSource(obs_source_t *scene_source)
+{
+	prewarmHoverSource = OBSGetWeakRef(scene_source);
+	if (!scene_source) {
+		prewarmDwellTimer.stop();
+		return;
+	}
+	prewarmDwellTimer.start(SCENE_PREWARM_DWELL_MS);
+}
+
+void CanvasDock::PrewarmScene(const QString &scene_name)
+{
+	PrewarmSource(sceneModel->Source(sceneModel->Row(scene_name)));
+}
+
+void CanvasDock::ExpirePrewarmedScenes(bool all)
+{
+	if (all) {
+		prewarmDwellTimer.stop();
+	}
+	const uint64_t now = os_gettime_ns();
+	for (auto it = prewarmedScenes.begin(); it != prewarmedScenes.end();) {
+		if (!all && it->second.expires > now) {
+			++it;
+			continue;
+		}
+		obs_source_dec_showing(it->second.source);
+		it = prewarmedScenes.erase(it);
+	}
+	if (prewarmedScenes.empty()) {
+		prewarmTimer.stop();
+	}
+}
+
 void CanvasDock::AddScene(QString duplicate, bool ask_name)
 {
 	std::string name = duplicate.isEmpty() ? obs_module_text("VerticalScene") : duplicate.toUtf8().constData();
@@ -830,34 +1211,12 @@ void CanvasDock::AddScene(QString duplicate, bool ask_name)
 			obs_scene_t *canvas_scene = obs_canvas_scene_create(canvas, name.c_str());
 			new_scene = obs_scene_get_source(canvas_scene);
 
-			std::string ssn = obs_canvas_get_name(canvas);
-			ssn += " ";
-			ssn += obs_frontend_get_locale_string("Basic.Hotkeys.SelectScene");
-			obs_hotkey_register_source(
-				new_scene, "OBSBasic.SelectScene", ssn.c_str(),
-				[](void *data, obs_hotkey_id, obs_hotkey_t *key, bool pressed) {
-					if (!pressed) {
-						return;
-					}
-					auto p = (CanvasDock *)data;
-					auto potential_source = (obs_weak_source_t *)obs_hotkey_get_registerer(key);
-					OBSSourceAutoRelease source = obs_weak_source_get_source(potential_source);
-					if (source) {
-						auto sn = QString::fromUtf8(obs_source_get_name(source));
-						QMetaObject::invokeMethod(p, "SwitchScene", Q_ARG(QString, sn), Q_ARG(bool, true));
-					}
-				},
-				this);
+			RegisterSceneHotkeys(new_scene);
 		}
 		auto sh = obs_source_get_signal_handler(new_scene);
 		signal_handler_connect(sh, "rename", source_rename, this);
 		auto sn = QString::fromUtf8(obs_source_get_name(new_scene));
-		if (scenesCombo) {
-			scenesCombo->addItem(sn);
-		}
-		if (scenesDock) {
-			scenesDock->sceneList->addItem(sn);
-		}
+		sceneModel->Add(new_scene);
 
 		SwitchScene(sn);
 		obs_source_release(new_scene);
@@ -899,7 +1258,7 @@ void CanvasDock::SetLinkedScene(obs_source_t *scene_, const QString &linkedScene
 		if (!item) {
 			continue;
 		}
-		if (obs_data_get_int(item, "width") == canvas_width && obs_data_get_int(item, "height") == canvas_height) {
+		if (IsLinkedEntry(item)) {
 			found = item;
 			if (linkedScene.isEmpty()) {
 				obs_data_array_erase(c, i);
@@ -917,6 +1276,7 @@ void CanvasDock::SetLinkedScene(obs_source_t *scene_, const QString &linkedScene
 			found = obs_data_create();
 			obs_data_set_int(found, "width", canvas_width);
 			obs_data_set_int(found, "height", canvas_height);
+			obs_data_set_string(found, "canvas_name", canvas_name.c_str());
 			obs_data_array_push_back(c, found);
 		}
 		obs_data_set_string(found, "scene", linkedScene.toUtf8().constData());
@@ -924,25 +1284,140 @@ void CanvasDock::SetLinkedScene(obs_source_t *scene_, const QString &linkedScene
 	obs_data_release(ss);
 	obs_data_release(found);
 	obs_data_array_release(c);
+	UpdateLinkedScene(scene_, linkedScene.isEmpty() ? nullptr : linkedScene.toUtf8().constData());
 }
 
-bool CanvasDock::HasScene(QString sceneName) const
+bool CanvasDock::GetLinkedSceneName(obs_source_t *main_scene, std::string &linked_name) const
 {
-	if (scenesCombo) {
-		for (int i = 0; i < scenesCombo->count(); i++) {
-			if (sceneName == scenesCombo->itemText(i)) {
-				return true;
-			}
+	auto ss = obs_source_get_settings(main_scene);
+	auto c = obs_data_get_array(ss, "canvas");
+	obs_data_release(ss);
+	if (!c) {
+		return false;
+	}
+	bool found = false;
+	const auto count = obs_data_array_count(c);
+	for (size_t i = 0; i < count && !found; i++) {
+		auto item = obs_data_array_item(c, i);
+		if (!item) {
+			continue;
+		}
+		if (IsLinkedEntry(item)) {
+			linked_name = obs_data_get_string(item, "scene");
+			found = true;
 		}
+		obs_data_release(item);
 	}
-	if (scenesDock) {
-		for (int i = 0; i < scenesDock->sceneList->count(); i++) {
-			if (sceneName == scenesDock->sceneList->item(i)->text()) {
-				return true;
-			}
+	obs_data_array_release(c);
+	return found;
+}
+
+void CanvasDock::UpdateLinkedScene(obs_source_t *main_scene, const char *linked_name)
+{
+	const char *uuid = obs_source_get_uuid(main_scene);
+	if (!uuid) {
+		return;
+	}
+	obs_scene_t *linked = linked_name && *linked_name ? obs_canvas_get_scene_by_name(canvas, linked_name) : nullptr;
+	if (linked) {
+		linkedScenes[uuid] = LinkedScene{OBSGetWeakRef(main_scene), OBSGetWeakRef(obs_scene_get_source(linked))};
+		obs_scene_release(linked);
+	} else {
+		linkedScenes.erase(uuid);
+	}
+}
+
+OBSSource CanvasDock::GetLinkedScene(obs_source_t *main_scene) const
+{
+	const char *uuid = main_scene ? obs_source_get_uuid(main_scene) : nullptr;
+	if (!uuid) {
+		return OBSSource();
+	}
+	auto it = linkedScenes.find(uuid);
+	return it == linkedScenes.end() ? OBSSource() : OBSGetStrongRef(it->second.linked);
+}
+
+void CanvasDock::RebuildLinkedScenes()
+{
+	linkedScenes.clear();
+	struct obs_frontend_source_list scenes = {};
+	obs_frontend_get_scenes(&scenes);
+	for (size_t i = 0; i < scenes.sources.num; i++) {
+		std::string linked_name;
+		if (GetLinkedSceneName(scenes.sources.array[i], linked_name)) {
+			UpdateLinkedScene(scenes.sources.array[i], linked_name.c_str());
 		}
 	}
-	return false;
+	obs_frontend_source_list_free(&scenes);
+}
+
+// runs inside the main transition_start signal; the main transition only begins rendering on the next graphics tick,
+// so starting the linked transition here keeps both canvases on the same frame
+void CanvasDock::MainTransitionStarted(obs_source_t *transition, uint64_t start_ns, uint64_t frame_time)
+{
+	if (clearing || switching || linkedScenes.empty()) {
+		return;
+	}
+	OBSSourceAutoRelease dest = obs_transition_get_source(transition, OBS_TRANSITION_SOURCE_B);
+	if (!dest) {
+		return;
+	}
+	OBSSource linked = GetLinkedScene(dest);
+	if (!linked || linked == obs_scene_get_source(scene)) {
+		return;
+	}
+	SwitchScene(QString::fromUtf8(obs_source_get_name(linked)));
+
+	// this is the time spent switching inside the signal, not a measured frame skew between the canvases; a switch
+	// that crossed a graphics tick is counted as late
+	const uint64_t handler_ns = os_gettime_ns() - start_ns;
+	linkedSwitchCount++;
+	if (obs_get_video_frame_time() != frame_time) {
+		linkedSwitchLateCount++;
+	}
+	linkedSwitchLastHandlerNs = handler_ns;
+	linkedSwitchMaxHandlerNs = std::max(linkedSwitchMaxHandlerNs, handler_ns);
+}
+
+bool CanvasDock::IsLinkedEntry(obs_data_t *item) const
+{
+	if (obs_data_get_int(item, "width") != canvas_width || obs_data_get_int(item, "height") != canvas_height) {
+		return false;
+	}
+	const char *cn = obs_data_get_string(item, "canvas_name");
+	return !cn || !strlen(cn) || canvas_name == cn;
+}
+
+bool CanvasDock::MatchesCanvas(const char *uuid, long long width, long long height) const
+{
+	if (uuid && strlen(uuid)) {
+		return canvas_uuid == uuid || (canvas && strcmp(obs_canvas_get_uuid(canvas), uuid) == 0);
+	}
+	return (!width || canvas_width == width) && (!height || canvas_height == height);
+}
+
+bool CanvasDock::HasScene(QString sceneName) const
+{
+	return sceneModel && sceneModel->Row(sceneName) >= 0;
+}
+
+void CanvasDock::SetCurrentSceneRow(int row)
+{
+	if (row < 0) {
+		return;
+	}
+	if (scenesCombo && scenesCombo->currentIndex() != row) {
+		scenesCombo->setCurrentIndex(row);
+	}
+	if (scenesDock && scenesDock->CurrentRow() != row) {
+		scenesDock->SetCurrentRow(row);
+	}
+}
+
+// a target that dropped and is waiting for or running a plugin reconnect still counts as streaming
+static bool stream_output_live(const StreamServer &s)
+{
+	return s.output && (s.reconnect_pending || (!s.stopping && (s.was_live || obs_output_active(s.output))));
 }
 
 void CanvasDock::CheckReplayBuffer(bool start)
@@ -957,7 +1432,7 @@ void CanvasDock::CheckReplayBuffer(bool start)
 	bool active = obs_frontend_streaming_active() || obs_frontend_recording_active() || obs_frontend_replay_buffer_active() ||
 		      (recordOutput && obs_output_active(recordOutput));
 	for (auto it = streamOutputs.begin(); !active && it != streamOutputs.end(); ++it) {
-		active = it->enabled && it->output && !it->stopping && obs_output_active(it->output);
+		active = it->enabled && stream_output_live(*it);
 	}
 
 	if (start && active) {
@@ -976,7 +1451,9 @@ void CanvasDock::CreateScenesRow()
 {
 	const auto sceneRow = new QHBoxLayout(this);
 	scenesCombo = new QComboBox;
+	scenesCombo->setModel(sceneModel);
 	connect(scenesCombo, &QComboBox::currentTextChanged, [this]() { SwitchScene(scenesCombo->currentText()); });
+	connect(scenesCombo, &QComboBox::highlighted, [this](int index) { HoverPrewarmSource(sceneModel->Source(index)); });
 	sceneRow->addWidget(scenesCombo, 1);
 
 	linkedButton = new LockedCheckBox;
@@ -1023,6 +1500,30 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		first_time = true;
 	}
 	partnerBlockTime = (time_t)obs_data_get_int(settings, "partner_block");
+	dock_id = obs_data_get_string(settings, "dock_id");
+	if (dock_id.empty()) {
+		dock_id = "VerticalCanvasDock";
+	}
+	canvas_name = obs_data_get_string(settings, "canvas_name");
+	if (canvas_name.empty()) {
+		canvas_name = CANVAS_NAME;
+	}
+	// the obs canvas only exists once video is started, so the dock keeps its own stable uuid for lookups
+	canvas_uuid = obs_data_get_string(settings, "canvas_uuid");
+	for (const auto &it : canvas_docks) {
+		if (canvas_uuid == it->GetCanvasUuid()) {
+			canvas_uuid.clear();
+		}
+	}
+	if (canvas_uuid.empty()) {
+		char *uuid = os_generate_uuid();
+		canvas_uuid = uuid;
+		bfree(uuid);
+	}
+	dock_title = obs_data_get_string(settings, "title");
+	if (dock_title.empty()) {
+		dock_title = obs_module_text("Vertical");
+	}
 	canvas_width = (uint32_t)obs_data_get_int(settings, "width");
 	if ((canvas_width & 1) == 1) {
 		canvas_width++;
@@ -1046,6 +1547,7 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	}
 	max_size_mb = (uint32_t)obs_data_get_int(settings, "max_size_mb");
 	max_time_sec = (uint32_t)obs_data_get_int(settings, "max_time_sec");
+	record_write_buffer_mb = (uint32_t)obs_data_get_int(settings, "record_write_buffer_mb");
 	recordingMatchMain = obs_data_get_bool(settings, "recording_match_main");
 
 	audioBitrate = (uint32_t)obs_data_get_int(settings, "audio_bitrate");
@@ -1053,12 +1555,17 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	replayAlwaysOn = false;
 	replayDuration = (uint32_t)obs_data_get_int(settings, "backtrack_seconds");
 	replayPath = obs_data_get_string(settings, "backtrack_path");
+	replayDisk = obs_data_get_bool(settings, "backtrack_disk");
 
 	virtual_cam_mode = (uint32_t)obs_data_get_int(settings, "virtual_camera_mode");
 
 	auto so = obs_data_get_array(settings, "stream_outputs");
 	multi_rtmp = LoadStreamOutputs(so);
 	obs_data_array_release(so);
+
+	auto dca = obs_data_get_array(settings, "derived_canvases");
+	LoadDerivedCanvases(dca);
+	obs_data_array_release(dca);
 	if (streamOutputs.empty() && strlen(obs_data_get_string(settings, "stream_server"))) {
 		StreamServer ss;
 		ss.stream_server = obs_data_get_string(settings, "stream_server");
@@ -1072,6 +1579,16 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	stream_delay_enabled = obs_data_get_bool(settings, "stream_delay_enabled");
 	stream_delay_duration = (uint32_t)obs_data_get_int(settings, "stream_delay_duration");
 	stream_delay_preserve = obs_data_get_bool(settings, "stream_delay_preserve");
+	stream_start_parallel = (int)obs_data_get_int(settings, "stream_start_parallel");
+	stream_start_stagger_ms = (int)obs_data_get_int(settings, "stream_start_stagger_ms");
+	obs_data_set_default_int(settings, "scene_prewarm_ttl_ms", 5000);
+	scene_prewarm_ttl_ms = (int)obs_data_get_int(settings, "scene_prewarm_ttl_ms");
+	connect(&prewarmTimer, &QTimer::timeout, this, [this] { ExpirePrewarmedScenes(false); });
+	prewarmDwellTimer.setSingleShot(true);
+	connect(&prewarmDwellTimer, &QTimer::timeout, this, [this] {
+		OBSSource source = OBSGetStrongRef(prewarmHoverSource);
+		PrewarmSource(source);
+	});
 
 	stream_advanced_settings = obs_data_get_bool(settings, "stream_advanced_settings");
 	stream_audio_track = (int)obs_data_get_int(settings, "stream_audio_track");
@@ -1096,6 +1613,7 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	}
 
 	preview_disabled = obs_data_get_bool(settings, "preview_disabled");
+	show_stats = obs_data_get_bool(settings, "show_stats");
 
 	virtual_cam_warned = obs_data_get_bool(settings, "virtual_cam_warned");
 
@@ -1153,7 +1671,7 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	setContentsMargins(0, 0, 0, 0);
 	setLayout(mainLayout);
 
-	const QString title = QString::fromUtf8(obs_module_text("Vertical"));
+	const QString title = QString::fromUtf8(dock_title.c_str());
 
 	const QString replayName = title + " " + QString::fromUtf8(obs_module_text("Backtrack"));
 	auto hotkeyData = obs_data_get_obj(settings, "backtrack_hotkeys");
@@ -1162,23 +1680,37 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	auto rpsh = obs_output_get_signal_handler(replayOutput);
 	signal_handler_connect(rpsh, "saved", replay_saved, this);
 
+	sceneModel = new CanvasScenesModel(this);
+	auto scheduleThumbnailScenes = [this] {
+		if (!thumbnailsActive || thumbnailScenesPending) {
+			return;
+		}
+		thumbnailScenesPending = true;
+		QMetaObject::invokeMethod(this, [this] { UpdateThumbnailScenes(); }, Qt::QueuedConnection);
+	};
+	connect(sceneModel, &QAbstractItemModel::rowsInserted, this, scheduleThumbnailScenes);
+	connect(sceneModel, &QAbstractItemModel::rowsRemoved, this, scheduleThumbnailScenes);
+	connect(sceneModel, &QAbstractItemModel::rowsMoved, this, scheduleThumbnailScenes);
+	connect(sceneModel, &QAbstractItemModel::modelReset, this, scheduleThumbnailScenes);
+	connect(sceneModel, &QAbstractItemModel::layoutChanged, this, scheduleThumbnailScenes);
 	if (obs_data_get_bool(settings, "scenes_row")) {
 		CreateScenesRow();
 	}
 	scenesDock = new CanvasScenesDock(this, parent);
 	scenesDock->SetGridMode(obs_data_get_bool(settings, "grid_mode"));
 
-	const auto scenesName = "VerticalCanvasDockScenes";
+	const auto scenesName = dock_id + "Scenes";
 	const auto scenesTitle = title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.Scenes"));
-	obs_frontend_add_dock_by_id(scenesName, scenesTitle.toUtf8().constData(), scenesDock);
+	obs_frontend_add_dock_by_id(scenesName.c_str(), scenesTitle.toUtf8().constData(), scenesDock);
 	sourcesDock = new CanvasSourcesDock(this, parent);
-	const auto sourcesName = "VerticalCanvasDockSources";
+	sourcesDock->sourceList->SetVirtualized(obs_data_get_bool(settings, "virtual_source_list"));
+	const auto sourcesName = dock_id + "Sources";
 	const auto sourcesTitle = title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.Sources"));
-	obs_frontend_add_dock_by_id(sourcesName, sourcesTitle.toUtf8().constData(), sourcesDock);
+	obs_frontend_add_dock_by_id(sourcesName.c_str(), sourcesTitle.toUtf8().constData(), sourcesDock);
 	transitionsDock = new CanvasTransitionsDock(this, parent);
-	const auto transitionsName = "VerticalCanvasDockTransitions";
+	const auto transitionsName = dock_id + "Transitions";
 	const auto transitionsTitle = title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.SceneTransitions"));
-	obs_frontend_add_dock_by_id(transitionsName, transitionsTitle.toUtf8().constData(), transitionsDock);
+	obs_frontend_add_dock_by_id(transitionsName.c_str(), transitionsTitle.toUtf8().constData(), transitionsDock);
 	preview->setObjectName(QStringLiteral("preview"));
 	preview->setMinimumSize(QSize(24, 24));
 	QSizePolicy sizePolicy1(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -1280,6 +1812,19 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		QString::fromUtf8("QPushButton:checked{background: rgb(0,210,153);}") +
 		QString::fromUtf8(multi_rtmp ? "QPushButton{border-top-right-radius: 0; border-bottom-right-radius: 0;}" : ""));
 	connect(streamButton, SIGNAL(clicked()), this, SLOT(StreamButtonClicked()));
+	streamButton->setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(streamButton, &QPushButton::customContextMenuRequested, [this] {
+		if (StreamingActive()) {
+			return;
+		}
+		QMenu menu;
+		if (streamArmed) {
+			menu.addAction(QString::fromUtf8(obs_module_text("DisarmStream")), [this] { DisarmStream(); });
+		} else {
+			menu.addAction(QString::fromUtf8(obs_module_text("ArmStream")), [this] { ArmStream(); });
+		}
+		menu.exec(QCursor::pos());
+	});
 	streamButtonGroup->layout()->addWidget(streamButton);
 
 	// Little up arrow in the case of there being multiple enabled outputs
@@ -1345,9 +1890,9 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	});
 
 	backtrack_hotkey = obs_hotkey_pair_register_frontend(
-		"VerticalCanvasDockStartBacktrack",
+		(dock_id + "StartBacktrack").c_str(),
 		(title + " " + QString::fromUtf8(obs_module_text("BacktrackOn"))).toUtf8().constData(),
-		"VerticalCanvasDockStopBacktrack",
+		(dock_id + "StopBacktrack").c_str(),
 		(title + " " + QString::fromUtf8(obs_module_text("BacktrackOff"))).toUtf8().constData(),
 		[](void *param, obs_hotkey_pair_id, obs_hotkey_t *, bool pressed) {
 			auto cd = (CanvasDock *)param;
@@ -1442,12 +1987,22 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 		if (streamButton->text() != streamButtonText) {
 			streamButton->setText(streamButtonText);
 		}
+		UpdateStreamHealth();
+		UpdateAdaptiveBitrate();
+		SampleStats();
 	});
 	recordDurationTimer.start();
 
+	streamStartTimer.setSingleShot(true);
+	connect(&streamStartTimer, &QTimer::timeout, this, &CanvasDock::StartNextStreamOutputs);
+
 	replayStatusResetTimer.setInterval(4000);
 	replayStatusResetTimer.setSingleShot(true);
 	connect(&replayStatusResetTimer, &QTimer::timeout, [this] { statusLabel->setText(""); });
+	replaySaveTimeoutTimer.setSingleShot(true);
+	connect(&replaySaveTimeoutTimer, &QTimer::timeout, this, &CanvasDock::ReplaySaveTimedOut);
+	streamFirstPacketTimer.setInterval(STREAM_FIRST_PACKET_POLL_MS);
+	connect(&streamFirstPacketTimer, &QTimer::timeout, this, &CanvasDock::CheckStreamFirstPacket);
 
 	configButton = new QPushButton(this);
 	configButton->setMinimumHeight(30);
@@ -1496,6 +2051,13 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 
 	mainLayout->addLayout(buttonRow);
 
+	statsLabel = new QLabel;
+	statsLabel->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Fixed);
+	statsLabel->setTextFormat(Qt::PlainText);
+	statsLabel->setStyleSheet(QString::fromUtf8("QLabel{font-family: monospace;}"));
+	statsLabel->setVisible(show_stats);
+	mainLayout->addWidget(statsLabel);
+
 	obs_enter_graphics();
 
 	gs_render_start(true);
@@ -1513,14 +2075,14 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	signal_handler_connect(sh, "source_rename", source_rename, this);
 	signal_handler_connect(sh, "source_remove", source_remove, this);
 	signal_handler_connect(sh, "source_destroy", source_remove, this);
-	//signal_handler_connect(sh, "source_create", source_create, this);
+	signal_handler_connect(sh, "source_create", source_create, this);
 	//signal_handler_connect(sh, "source_load", source_load, this);
 	signal_handler_connect(sh, "source_save", source_save, this);
 
 	virtual_cam_hotkey = obs_hotkey_pair_register_frontend(
-		"VerticalCanvasDockStartVirtualCam",
+		(dock_id + "StartVirtualCam").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.StartVirtualCam"))).toUtf8().constData(),
-		"VerticalCanvasDockStopVirtualCam",
+		(dock_id + "StopVirtualCam").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.StopVirtualCam"))).toUtf8().constData(),
 		start_virtual_cam_hotkey, stop_virtual_cam_hotkey, this, this);
 
@@ -1531,9 +2093,9 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	obs_data_array_release(stop_hotkey);
 
 	record_hotkey = obs_hotkey_pair_register_frontend(
-		"VerticalCanvasDockStartRecording",
+		(dock_id + "StartRecording").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.StartRecording"))).toUtf8().constData(),
-		"VerticalCanvasDockStopRecording",
+		(dock_id + "StopRecording").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.StopRecording"))).toUtf8().constData(),
 		start_recording_hotkey, stop_recording_hotkey, this, this);
 
@@ -1544,9 +2106,9 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	obs_data_array_release(stop_hotkey);
 
 	stream_hotkey = obs_hotkey_pair_register_frontend(
-		"VerticalCanvasDockStartStreaming",
+		(dock_id + "StartStreaming").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.StartStreaming"))).toUtf8().constData(),
-		"VerticalCanvasDockStopStreaming",
+		(dock_id + "StopStreaming").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.StopStreaming"))).toUtf8().constData(),
 		start_streaming_hotkey, stop_streaming_hotkey, this, this);
 
@@ -1557,9 +2119,9 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	obs_data_array_release(stop_hotkey);
 
 	pause_hotkey = obs_hotkey_pair_register_frontend(
-		"VerticalCanvasDockPause",
+		(dock_id + "Pause").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.PauseRecording"))).toUtf8().constData(),
-		"VerticalCanvasDockUnpause",
+		(dock_id + "Unpause").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.UnpauseRecording")))
 			.toUtf8()
 			.constData(),
@@ -1572,11 +2134,11 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	obs_data_array_release(stop_hotkey);
 
 	preview_hotkey = obs_hotkey_pair_register_frontend(
-		"VerticalCanvasDockShowPreview",
+		(dock_id + "ShowPreview").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.PreviewConextMenu.Enable")))
 			.toUtf8()
 			.constData(),
-		"VerticalCanvasDockHidePreview",
+		(dock_id + "HidePreview").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.Preview.Disable"))).toUtf8().constData(),
 		show_preview_hotkey, hide_preview_hotkey, this, this);
 
@@ -1587,7 +2149,7 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	obs_data_array_release(stop_hotkey);
 
 	chapter_hotkey = obs_hotkey_register_frontend(
-		"VerticalCanvasDockChapter",
+		(dock_id + "Chapter").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.AddChapterMarker")))
 			.toUtf8()
 			.constData(),
@@ -1598,7 +2160,7 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	obs_data_array_release(start_hotkey);
 
 	split_hotkey = obs_hotkey_register_frontend(
-		"VerticalCanvasDockSplit",
+		(dock_id + "Split").c_str(),
 		(title + " " + QString::fromUtf8(obs_frontend_get_locale_string("Basic.Main.SplitFile"))).toUtf8().constData(),
 		recording_split_hotkey, this);
 
@@ -1606,6 +2168,15 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 	obs_hotkey_load(split_hotkey, start_hotkey);
 	obs_data_array_release(start_hotkey);
 
+	save_disk_backtrack_hotkey = obs_hotkey_register_frontend(
+		(dock_id + "SaveDiskBacktrack").c_str(),
+		(title + " " + QString::fromUtf8(obs_module_text("SaveDiskBacktrackHotkey"))).toUtf8().constData(),
+		save_disk_backtrack_hotkey_pressed, this);
+
+	start_hotkey = obs_data_get_array(settings, "save_disk_backtrack_hotkey");
+	obs_hotkey_load(save_disk_backtrack_hotkey, start_hotkey);
+	obs_data_array_release(start_hotkey);
+
 	if (first_time) {
 		obs_data_release(settings);
 	}
@@ -1632,6 +2203,7 @@ CanvasDock::CanvasDock(obs_data_t *settings, QWidget *parent)
 CanvasDock::~CanvasDock()
 {
 	obs_frontend_remove_save_callback(save_load, this);
+	obs_data_release(stats);
 	for (auto projector : projectors) {
 		delete projector;
 	}
@@ -1644,7 +2216,13 @@ CanvasDock::~CanvasDock()
 	obs_hotkey_pair_unregister(preview_hotkey);
 	obs_hotkey_unregister(chapter_hotkey);
 	obs_hotkey_unregister(split_hotkey);
+	obs_hotkey_unregister(save_disk_backtrack_hotkey);
+#ifdef ENABLE_REMUX_QUEUE
+	remux_queue_remove_param(this);
+#endif
 	obs_display_remove_draw_callback(preview->GetDisplay(), DrawPreview, this);
+	obs_remove_main_render_callback(RenderSceneThumbnail, this);
+	ExpirePrewarmedScenes(true);
 	for (uint32_t i = MAX_CHANNELS - 1; i > 0; i--) {
 		auto s = obs_get_output_source(i);
 		if (s == transitionAudioWrapper) {
@@ -1663,7 +2241,7 @@ CanvasDock::~CanvasDock()
 	signal_handler_disconnect(sh, "source_rename", source_rename, this);
 	signal_handler_disconnect(sh, "source_remove", source_remove, this);
 	signal_handler_disconnect(sh, "source_destroy", source_remove, this);
-	//signal_handler_disconnect(sh, "source_create", source_create, this);
+	signal_handler_disconnect(sh, "source_create", source_create, this);
 	//signal_handler_disconnect(sh, "source_load", source_load, this);
 	signal_handler_disconnect(sh, "source_save", source_save, this);
 
@@ -1684,6 +2262,20 @@ CanvasDock::~CanvasDock()
 	obs_output_release(replayOutput);
 	replayOutput = nullptr;
 
+	if (diskReplayOutput) {
+		auto drsh = obs_output_get_signal_handler(diskReplayOutput);
+		signal_handler_disconnect(drsh, "file_changed", disk_replay_file_changed, this);
+		signal_handler_disconnect(drsh, "start", replay_output_start, this);
+		signal_handler_disconnect(drsh, "stop", replay_output_stop, this);
+	}
+	if (obs_output_active(diskReplayOutput)) {
+		obs_output_stop(diskReplayOutput);
+	}
+	obs_output_release(diskReplayOutput);
+	diskReplayOutput = nullptr;
+	backtrack_ring_destroy(diskReplayRing);
+	diskReplayRing = nullptr;
+
 	if (obs_output_active(virtualCamOutput)) {
 		obs_output_stop(virtualCamOutput);
 	}
@@ -1700,6 +2292,11 @@ CanvasDock::~CanvasDock()
 	}
 	streamOutputs.clear();
 
+	for (auto &dc : derivedCanvases) {
+		ReleaseDerivedCanvas(dc);
+	}
+	derivedCanvases.clear();
+
 	obs_data_release(stream_encoder_settings);
 	obs_data_release(record_encoder_settings);
 
@@ -1721,7 +2318,7 @@ CanvasDock::~CanvasDock()
 
 	auto ph = obs_get_proc_handler();
 	calldata_t cd = {0};
-	calldata_set_string(&cd, "canvas_name", CANVAS_NAME);
+	calldata_set_string(&cd, "canvas_name", canvas_name.c_str());
 	proc_handler_call(ph, "downstream_keyer_remove_canvas", &cd);
 	calldata_free(&cd);
 
@@ -1744,6 +2341,15 @@ CanvasDock::~CanvasDock()
 	if (circleFill) {
 		gs_vertexbuffer_destroy(circleFill);
 	}
+	if (spacerAtlas) {
+		gs_texture_destroy(spacerAtlas);
+	}
+	if (texrender) {
+		gs_texrender_destroy(texrender);
+	}
+	if (stagesurface) {
+		gs_stagesurface_destroy(stagesurface);
+	}
 
 	gs_vertexbuffer_destroy(box);
 	obs_leave_graphics();
@@ -1947,10 +2553,16 @@ void CanvasDock::DrawBackdrop(float cx, float cy)
 	GS_DEBUG_MARKER_END();
 }
 
+static const char *draw_preview_name = "vertical_canvas_draw_preview";
+static const char *draw_selected_items_name = "vertical_canvas_draw_selected_items";
+static const char *draw_spacing_helpers_name = "vertical_canvas_draw_spacing_helpers";
+
 void CanvasDock::DrawPreview(void *data, uint32_t cx, uint32_t cy)
 {
 	CanvasDock *window = static_cast<CanvasDock *>(data);
 
+	profile_start(draw_preview_name);
+
 	uint32_t sourceCX = window->canvas_width;
 	if (sourceCX <= 0) {
 		sourceCX = 1;
@@ -2006,10 +2618,12 @@ void CanvasDock::DrawPreview(void *data, uint32_t cx, uint32_t cy)
 	gs_technique_begin_pass(tech, 0);
 
 	if (window->scene && !window->locked) {
+		profile_start(draw_selected_items_name);
 		gs_matrix_push();
 		gs_matrix_scale3f(scale, scale, 1.0f);
 		obs_scene_enum_items(window->scene, DrawSelectedItem, data);
 		gs_matrix_pop();
+		profile_end(draw_selected_items_name);
 	}
 
 	if (window->selectionBox) {
@@ -2033,22 +2647,171 @@ void CanvasDock::DrawPreview(void *data, uint32_t cx, uint32_t cy)
 	gs_technique_end(tech);
 
 	if (window->drawSpacingHelpers) {
+		profile_start(draw_spacing_helpers_name);
 		window->DrawSpacingHelpers(window->scene, (float)x, (float)y, newCX, newCY, scale, float(sourceCX),
 					   float(sourceCY));
+		profile_end(draw_spacing_helpers_name);
 	}
 
 	gs_projection_pop();
 	gs_viewport_pop();
-}
 
-struct SceneFindData {
-	const vec2 &pos;
-	OBSSceneItem item;
-	bool selectBelow;
+	profile_end(draw_preview_name);
+}
 
-	obs_sceneitem_t *group = nullptr;
+static const char *render_thumbnail_name = "vertical_canvas_render_scene_thumbnail";
 
-	SceneFindData(const SceneFindData &) = delete;
+QSize CanvasDock::GetThumbnailSize() const
+{
+	const uint32_t cy = THUMBNAIL_HEIGHT;
+	uint32_t cx = canvas_height ? cy * canvas_width / canvas_height : cy * 9 / 16;
+	if (!cx) {
+		cx = 1;
+	}
+	return QSize((int)cx, (int)cy);
+}
+
+void CanvasDock::SetSceneThumbnails(bool enable)
+{
+	if (thumbnailsActive == enable) {
+		return;
+	}
+	thumbnailsActive = enable;
+	sceneModel->SetThumbnailsEnabled(enable);
+	if (enable) {
+		UpdateThumbnailScenes();
+		obs_add_main_render_callback(RenderSceneThumbnail, this);
+	} else {
+		obs_remove_main_render_callback(RenderSceneThumbnail, this);
+		std::lock_guard<std::mutex> lock(thumbnailMutex);
+		thumbnailScenes.clear();
+	}
+}
+
+void CanvasDock::UpdateThumbnailScenes()
+{
+	thumbnailScenesPending = false;
+	if (!thumbnailsActive) {
+		return;
+	}
+	std::vector<OBSWeakSource> scenes;
+	const int count = sceneModel->rowCount();
+	scenes.reserve(count);
+	for (int i = 0; i < count; i++) {
+		OBSSource scene = sceneModel->Source(i);
+		if (scene) {
+			scenes.push_back(OBSGetWeakRef(scene));
+		}
+	}
+	std::lock_guard<std::mutex> lock(thumbnailMutex);
+	thumbnailScenes.swap(scenes);
+}
+
+// maps the surface staged on the previous frame, so the copy never waits on the gpu
+void CanvasDock::DownloadSceneThumbnail()
+{
+	if (!thumbnailPending) {
+		return;
+	}
+	OBSSource scene = OBSGetStrongRef(thumbnailPending);
+	thumbnailPending = OBSWeakSource();
+	uint8_t *videoData = nullptr;
+	uint32_t videoLinesize = 0;
+	if (!scene || !gs_stagesurface_map(stagesurface, &videoData, &videoLinesize)) {
+		return;
+	}
+	const uint32_t cx = gs_stagesurface_get_width(stagesurface);
+	const uint32_t cy = gs_stagesurface_get_height(stagesurface);
+	QImage image((int)cx, (int)cy, QImage::Format_RGBA8888);
+	for (uint32_t y = 0; y < cy; y++) {
+		memcpy(image.scanLine((int)y), videoData + y * videoLinesize, cx * 4);
+	}
+	gs_stagesurface_unmap(stagesurface);
+
+	const QString uuid = QString::fromUtf8(obs_source_get_uuid(scene));
+	QMetaObject::invokeMethod(
+		this, [this, uuid, image] { sceneModel->SetThumbnail(uuid, image); }, Qt::QueuedConnection);
+}
+
+// renders at most one scene per frame, round-robin, and spaces renders out so thumbnails stay within a small share of the
+// render thread
+void CanvasDock::RenderSceneThumbnail(void *data, uint32_t cx, uint32_t cy)
+{
+	UNUSED_PARAMETER(cx);
+	UNUSED_PARAMETER(cy);
+	CanvasDock *window = static_cast<CanvasDock *>(data);
+
+	profile_start(render_thumbnail_name);
+
+	window->DownloadSceneThumbnail();
+
+	const uint64_t start = os_gettime_ns();
+	if (start < window->thumbnailNext || !window->canvas_width || !window->canvas_height) {
+		profile_end(render_thumbnail_name);
+		return;
+	}
+
+	OBSSource scene;
+	{
+		std::lock_guard<std::mutex> lock(window->thumbnailMutex);
+		const size_t count = window->thumbnailScenes.size();
+		for (size_t i = 0; !scene && i < count; i++) {
+			window->thumbnailIndex = (window->thumbnailIndex + 1) % count;
+			scene = OBSGetStrongRef(window->thumbnailScenes[window->thumbnailIndex]);
+		}
+	}
+	if (!scene) {
+		window->thumbnailNext = start + THUMBNAIL_MIN_INTERVAL_NS;
+		profile_end(render_thumbnail_name);
+		return;
+	}
+
+	const QSize size = window->GetThumbnailSize();
+	const uint32_t thumbCX = (uint32_t)size.width();
+	const uint32_t thumbCY = (uint32_t)size.height();
+	if (!window->texrender) {
+		window->texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	}
+	if (window->stagesurface && (gs_stagesurface_get_width(window->stagesurface) != thumbCX ||
+				     gs_stagesurface_get_height(window->stagesurface) != thumbCY)) {
+		gs_stagesurface_destroy(window->stagesurface);
+		window->stagesurface = nullptr;
+	}
+	if (!window->stagesurface) {
+		window->stagesurface = gs_stagesurface_create(thumbCX, thumbCY, GS_RGBA);
+	}
+
+	gs_texrender_reset(window->texrender);
+	if (gs_texrender_begin(window->texrender, thumbCX, thumbCY)) {
+		vec4 clear_color;
+		vec4_zero(&clear_color);
+		gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+		gs_ortho(0.0f, (float)window->canvas_width, 0.0f, (float)window->canvas_height, -100.0f, 100.0f);
+
+		gs_blend_state_push();
+		gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+		obs_source_video_render(scene);
+		gs_blend_state_pop();
+		gs_texrender_end(window->texrender);
+
+		gs_stage_texture(window->stagesurface, gs_texrender_get_texture(window->texrender));
+		window->thumbnailPending = OBSGetWeakRef(scene);
+	}
+
+	const uint64_t cost = os_gettime_ns() - start;
+	window->thumbnailNext = start + std::max<uint64_t>(THUMBNAIL_MIN_INTERVAL_NS, cost * THUMBNAIL_BUDGET_DIVISOR);
+
+	profile_end(render_thumbnail_name);
+}
+
+struct SceneFindData {
+	const vec2 &pos;
+	OBSSceneItem item;
+	bool selectBelow;
+
+	obs_sceneitem_t *group = nullptr;
+
+	SceneFindData(const SceneFindData &) = delete;
 	SceneFindData(SceneFindData &&) = delete;
 	SceneFindData &operator=(const SceneFindData &) = delete;
 	SceneFindData &operator=(SceneFindData &&) = delete;
@@ -2165,37 +2928,107 @@ void CanvasDock::DrawSpacingLine(vec3 &start, vec3 &end, vec3 &viewport, float p
 	gs_technique_end(tech);
 }
 
-void CanvasDock::SetLabelText(int sourceIndex, int px)
-{
+static const char *spacer_glyphs = "0123456789 px";
 
-	if (px == spacerPx[sourceIndex]) {
+// rasterizes the label characters once per pixel ratio so drawing a label is only textured quads
+void CanvasDock::CreateSpacerAtlas(float pixelRatio)
+{
+	if (spacerAtlas && spacerAtlasRatio == pixelRatio) {
 		return;
 	}
 
-	std::string text = std::to_string(px) + " px";
-
-	obs_source_t *s = spacerLabel[sourceIndex];
-
-	OBSDataAutoRelease settings = obs_source_get_settings(s);
-	obs_data_set_string(settings, "text", text.c_str());
-	obs_source_update(s, settings);
-
-	spacerPx[sourceIndex] = px;
+	QFont font;
+#if defined(_WIN32)
+	font.setFamily("Arial");
+#elif defined(__APPLE__)
+	font.setFamily("Helvetica");
+#else
+	font.setFamily("Monospace");
+#endif
+	font.setBold(true);
+	font.setPixelSize(std::max(1, (int)(16.0f * pixelRatio)));
+	const QFontMetricsF metrics(font);
+	const float outline = 3.0f * pixelRatio;
+	const float pad = ceilf(outline / 2.0f);
+
+	SpacerGlyph glyphs[13];
+	uint32_t width = 0;
+	for (size_t i = 0; i < sizeof(glyphs) / sizeof(glyphs[0]); i++) {
+		glyphs[i].advance = (float)metrics.horizontalAdvance(QChar(spacer_glyphs[i]));
+		glyphs[i].x = width;
+		glyphs[i].cx = (uint32_t)ceilf(glyphs[i].advance + pad * 2.0f);
+		width += glyphs[i].cx + 1;
+	}
+	const uint32_t height = (uint32_t)ceilf((float)metrics.height() + pad * 2.0f);
+
+	QImage image((int)width, (int)height, QImage::Format_RGBA8888);
+	image.fill(Qt::transparent);
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing);
+	const QPen outlinePen(Qt::black, outline, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+	for (size_t i = 0; i < sizeof(glyphs) / sizeof(glyphs[0]); i++) {
+		QPainterPath path;
+		path.addText((qreal)glyphs[i].x + pad, pad + metrics.ascent(), font, QString(QChar(spacer_glyphs[i])));
+		painter.strokePath(path, outlinePen);
+		painter.fillPath(path, Qt::white);
+	}
+	painter.end();
+
+	const uint8_t *data = image.constBits();
+	obs_enter_graphics();
+	if (spacerAtlas) {
+		gs_texture_destroy(spacerAtlas);
+	}
+	memcpy(spacerGlyphs, glyphs, sizeof(spacerGlyphs));
+	spacerAtlasHeight = height;
+	spacerAtlasPad = pad;
+	spacerAtlasRatio = pixelRatio;
+	spacerAtlas = gs_texture_create(width, height, GS_RGBA, 1, &data, 0);
+	obs_leave_graphics();
 }
 
-static void DrawLabel(OBSSource source, vec3 &pos, vec3 &viewport)
+float CanvasDock::GetSpacerLabelWidth(const char *text) const
 {
-	if (!source) {
-		return;
+	float width = spacerAtlasPad * 2.0f;
+	for (const char *c = text; *c; c++) {
+		const char *g = strchr(spacer_glyphs, *c);
+		if (g) {
+			width += spacerGlyphs[g - spacer_glyphs].advance;
+		}
 	}
+	return width;
+}
 
+void CanvasDock::DrawSpacerLabel(const char *text, vec3 &pos, vec3 &viewport)
+{
 	vec3_mul(&pos, &pos, &viewport);
 
+	gs_effect_t *effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+	gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), spacerAtlas);
+
+	gs_blend_state_push();
+	gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
+
 	gs_matrix_push();
 	gs_matrix_identity();
 	gs_matrix_translate(&pos);
-	obs_source_video_render(source);
+
+	while (gs_effect_loop(effect, "Draw")) {
+		gs_matrix_push();
+		for (const char *c = text; *c; c++) {
+			const char *g = strchr(spacer_glyphs, *c);
+			if (!g) {
+				continue;
+			}
+			const SpacerGlyph &glyph = spacerGlyphs[g - spacer_glyphs];
+			gs_draw_sprite_subregion(spacerAtlas, 0, glyph.x, 0, glyph.cx, spacerAtlasHeight);
+			gs_matrix_translate3f(glyph.advance, 0.0f, 0.0f);
+		}
+		gs_matrix_pop();
+	}
+
 	gs_matrix_pop();
+	gs_blend_state_pop();
 }
 
 void CanvasDock::RenderSpacingHelper(int sourceIndex, vec3 &start, vec3 &end, vec3 &viewport, float pixelRatio)
@@ -2221,9 +3054,11 @@ void CanvasDock::RenderSpacingHelper(int sourceIndex, vec3 &start, vec3 &end, ve
 		return;
 	}
 
-	obs_source_t *s = spacerLabel[sourceIndex];
+	char text[32];
+	snprintf(text, sizeof(text), "%d px", (int)px);
+
 	vec3 labelSize, labelPos;
-	vec3_set(&labelSize, (float)obs_source_get_width(s), (float)obs_source_get_height(s), 1.0f);
+	vec3_set(&labelSize, GetSpacerLabelWidth(text), (float)spacerAtlasHeight, 1.0f);
 
 	vec3_div(&labelSize, &labelSize, &viewport);
 
@@ -2243,42 +3078,7 @@ void CanvasDock::RenderSpacingHelper(int sourceIndex, vec3 &start, vec3 &end, ve
 	}
 
 	DrawSpacingLine(start, end, viewport, pixelRatio);
-	SetLabelText(sourceIndex, (int)px);
-	DrawLabel(s, labelPos, viewport);
-}
-
-static obs_source_t *CreateLabel(float pixelRatio, int i)
-{
-	OBSDataAutoRelease settings = obs_data_create();
-	OBSDataAutoRelease font = obs_data_create();
-
-#if defined(_WIN32)
-	obs_data_set_string(font, "face", "Arial");
-#elif defined(__APPLE__)
-	obs_data_set_string(font, "face", "Helvetica");
-#else
-	obs_data_set_string(font, "face", "Monospace");
-#endif
-	obs_data_set_int(font, "flags", 1); // Bold text
-	obs_data_set_int(font, "size", (int)(16.0f * pixelRatio));
-
-	obs_data_set_obj(settings, "font", font);
-	obs_data_set_bool(settings, "outline", true);
-
-#ifdef _WIN32
-	obs_data_set_int(settings, "outline_color", 0x000000);
-	obs_data_set_int(settings, "outline_size", 3);
-	const char *text_source_id = "text_gdiplus";
-#else
-	const char *text_source_id = "text_ft2_source";
-#endif
-
-	struct dstr name;
-	dstr_init(&name);
-	dstr_printf(&name, "Aitum Vertical Preview spacing label %d", i);
-	OBSSource txtSource = obs_source_create_private(text_source_id, name.array, settings);
-	dstr_free(&name);
-	return txtSource;
+	DrawSpacerLabel(text, labelPos, viewport);
 }
 
 obs_scene_item *CanvasDock::GetSelectedItem(obs_scene_t *s)
@@ -2441,16 +3241,12 @@ void CanvasDock::DrawSpacingHelpers(obs_scene_t *s, float x, float y, float cx,
 	// Draw spacer lines and labels
 	vec3 start, end;
 
-	float pixelRatio = 1.0f; //main->GetDevicePixelRatio();
-	if (!spacerLabel[3]) {
-		QMetaObject::invokeMethod(this, [this, pixelRatio]() {
-			for (int i = 0; i < 4; i++) {
-				if (!spacerLabel[i]) {
-					spacerLabel[i] = CreateLabel(pixelRatio, i);
-				}
-			}
-		});
-		return;
+	float pixelRatio = GetDevicePixelRatio();
+	if (!spacerAtlas || spacerAtlasRatio != pixelRatio) {
+		QMetaObject::invokeMethod(this, [this, pixelRatio]() { CreateSpacerAtlas(pixelRatio); });
+		if (!spacerAtlas) {
+			return;
+		}
 	}
 
 	vec3_set(&start, top.x, 0.0f, 1.0f);
@@ -3002,6 +3798,46 @@ static vec3 GetItemTL(obs_sceneitem_t *item)
 	return tl;
 }
 
+static bool CollectSelectedItems(obs_scene_t *, obs_sceneitem_t *item, void *param)
+{
+	if (obs_sceneitem_is_group(item)) {
+		obs_sceneitem_group_enum_items(item, CollectSelectedItems, param);
+	}
+	if (obs_sceneitem_selected(item)) {
+		static_cast<std::vector<OBSSceneItem> *>(param)->emplace_back(item);
+	}
+	return true;
+}
+
+// applies a transform edit to every selected item under one scene lock so the selection changes in a single frame.
+// with defer the transforms are only recalculated once per item after the whole edit, which only suits callbacks
+// that never read back the box transform (rotate and flip force an update to keep the top left corner in place)
+static void UpdateSelectedItems(obs_scene_t *scene, bool (*callback)(obs_scene_t *, obs_sceneitem_t *, void *), void *param,
+				bool defer = false)
+{
+	auto updateScene = [&]() {
+		std::vector<OBSSceneItem> items;
+		if (defer) {
+			obs_scene_enum_items(scene, CollectSelectedItems, &items);
+		}
+		for (auto &item : items) {
+			obs_sceneitem_defer_update_begin(item);
+		}
+		obs_scene_enum_items(scene, callback, param);
+		for (auto &item : items) {
+			obs_sceneitem_defer_update_end(item);
+		}
+	};
+
+	using updateScene_t = decltype(updateScene);
+
+	auto preUpdateScene = [](void *d, obs_scene_t *) {
+		(*static_cast<updateScene_t *>(d))();
+	};
+
+	obs_scene_atomic_update(scene, preUpdateScene, &updateScene);
+}
+
 static void SetItemTL(obs_sceneitem_t *item, const vec3 &tl)
 {
 	vec3 newTL;
@@ -3180,23 +4016,33 @@ void CanvasDock::CenterSelectedItems(CenterType centerType)
 	vec3_sub(&offset, &screenCenter, &center);
 
 	// Shift items by offset
-	for (auto &item : items) {
-		vec3 tl, br;
+	auto updateScene = [&]() {
+		for (auto &item : items) {
+			vec3 tl, br;
 
-		GetItemBox(item, tl, br);
+			GetItemBox(item, tl, br);
+
+			vec3_add(&tl, &tl, &offset);
 
-		vec3_add(&tl, &tl, &offset);
+			vec3 itemTL = GetItemTL(item);
 
-		vec3 itemTL = GetItemTL(item);
+			if (centerType == CenterType::Vertical) {
+				tl.x = itemTL.x;
+			} else if (centerType == CenterType::Horizontal) {
+				tl.y = itemTL.y;
+			}
 
-		if (centerType == CenterType::Vertical) {
-			tl.x = itemTL.x;
-		} else if (centerType == CenterType::Horizontal) {
-			tl.y = itemTL.y;
+			SetItemTL(item, tl);
 		}
+	};
 
-		SetItemTL(item, tl);
-	}
+	using updateScene_t = decltype(updateScene);
+
+	auto preUpdateScene = [](void *d, obs_scene_t *) {
+		(*static_cast<updateScene_t *>(d))();
+	};
+
+	obs_scene_atomic_update(scene, preUpdateScene, &updateScene);
 }
 
 void CanvasDock::AddSceneItemMenuItems(QMenu *popup, OBSSceneItem sceneItem)
@@ -3304,30 +4150,30 @@ void CanvasDock::AddSceneItemMenuItems(QMenu *popup, OBSSceneItem sceneItem)
 	transformMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Transform.Rotate90CW")),
 				 this, [this] {
 					 float rotation = 90.0f;
-					 obs_scene_enum_items(scene, RotateSelectedSources, &rotation);
+					 UpdateSelectedItems(scene, RotateSelectedSources, &rotation);
 				 });
 	transformMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Transform.Rotate90CCW")),
 				 this, [this] {
 					 float rotation = -90.0f;
-					 obs_scene_enum_items(scene, RotateSelectedSources, &rotation);
+					 UpdateSelectedItems(scene, RotateSelectedSources, &rotation);
 				 });
 	transformMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Transform.Rotate180")), this,
 				 [this] {
 					 float rotation = 180.0f;
-					 obs_scene_enum_items(scene, RotateSelectedSources, &rotation);
+					 UpdateSelectedItems(scene, RotateSelectedSources, &rotation);
 				 });
 	transformMenu->addSeparator();
 	transformMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Transform.FlipHorizontal")),
 				 this, [this] {
 					 vec2 scale;
 					 vec2_set(&scale, -1.0f, 1.0f);
-					 obs_scene_enum_items(scene, MultiplySelectedItemScale, &scale);
+					 UpdateSelectedItems(scene, MultiplySelectedItemScale, &scale);
 				 });
 	transformMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Transform.FlipVertical")),
 				 this, [this] {
 					 vec2 scale;
 					 vec2_set(&scale, 1.0f, -1.0f);
-					 obs_scene_enum_items(scene, MultiplySelectedItemScale, &scale);
+					 UpdateSelectedItems(scene, MultiplySelectedItemScale, &scale);
 				 });
 	transformMenu->addSeparator();
 	transformMenu->addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.Transform.FitToScreen")),
@@ -3463,11 +4309,25 @@ bool CanvasDock::HandleMouseReleaseEvent(QMouseEvent *event)
 		a = popup.addAction(QString::fromUtf8(obs_frontend_get_locale_string("PreviewWindow")),
 				    [this] { OpenProjector(-1); });
 
+		auto multiviewMenu = popup.addMenu(QString::fromUtf8(obs_frontend_get_locale_string("MultiviewProjector")));
+		AddProjectorMenuMonitors(multiviewMenu, this, SLOT(OpenMultiviewProjector()));
+
+		a = popup.addAction(QString::fromUtf8(obs_frontend_get_locale_string("MultiviewWindowed")),
+				    [this] { OpenProjector(-1, ProjectorType::Multiview); });
+
 		a = popup.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.MainMenu.Edit.LockPreview")), this,
 				    [this] { locked = !locked; });
 		a->setCheckable(true);
 		a->setChecked(locked);
 
+		a = popup.addAction(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats")), this, [this] {
+			show_stats = !show_stats;
+			statsLabel->setVisible(show_stats);
+			SampleStats();
+		});
+		a->setCheckable(true);
+		a->setChecked(show_stats);
+
 		popup.addAction(GetIconFromType(OBS_ICON_TYPE_IMAGE),
 				QString::fromUtf8(obs_frontend_get_locale_string("Screenshot")), this, [this] {
 					auto s = obs_weak_source_get_source(source);
@@ -4298,7 +5158,7 @@ void CanvasDock::MoveItems(const vec2 &pos)
 
 	vec2_add(&lastMoveOffset, &lastMoveOffset, &moveOffset);
 
-	obs_scene_enum_items(scene, move_items, &moveOffset);
+	UpdateSelectedItems(scene, move_items, &moveOffset, true);
 }
 
 struct SelectedItemBounds {
@@ -4932,55 +5792,90 @@ static void check_descendant(obs_source_t *parent, obs_source_t *child, void *pa
 	}
 }
 
-bool CanvasDock::add_sources_of_type_to_menu(void *param, obs_source_t *source)
+struct source_type_collect {
+	const char *id;
+	std::vector<OBSSource> sources;
+};
+
+static bool collect_sources_of_type(void *param, obs_source_t *source)
 {
-	QMenu *menu = static_cast<QMenu *>(param);
-	auto parent = qobject_cast<QMenu *>(menu->parent());
-	auto a = parent && !parent->menuAction()->data().isNull() ? parent->menuAction() : menu->menuAction();
-	while (parent && qobject_cast<QMenu *>(parent->parent())) {
-		parent = qobject_cast<QMenu *>(parent->parent());
-	}
-	CanvasDock *cd = static_cast<CanvasDock *>(parent ? parent->parent() : menu->parent());
-	auto t = a->data().toString();
-	auto idUtf8 = t.toUtf8();
-	const char *id = idUtf8.constData();
-	if (strcmp(obs_source_get_unversioned_id(source), id) == 0) {
-		auto name = QString::fromUtf8(obs_source_get_name(source));
-		QList<QAction *> actions = menu->actions();
-		QAction *after = nullptr;
-		for (QAction *menuAction : actions) {
-			if (menuAction->text().compare(name, Qt::CaseInsensitive) >= 0) {
-				after = menuAction;
-				break;
-			}
-		}
-		auto na = new QAction(name, menu);
-		connect(na, &QAction::triggered, cd, [cd, source] { cd->AddSourceToScene(source); }, Qt::QueuedConnection);
-		menu->insertAction(after, na);
-		struct descendant_info info = {false, cd->source, obs_scene_get_source(cd->scene)};
-		obs_source_enum_full_tree(source, check_descendant, &info);
-		na->setEnabled(!info.exists);
-	}
+	auto *c = static_cast<struct source_type_collect *>(param);
+	if (strcmp(obs_source_get_unversioned_id(source), c->id) == 0)
+		c->sources.emplace_back(source);
 	return true;
 }
 
+bool CanvasDock::WouldCreateCycle(obs_source_t *s)
+{
+	obs_source_t *target2 = obs_scene_get_source(scene);
+	long generation = source_index_scene_generation();
+	if (generation != cycleCacheGeneration || target2 != cycleCacheScene || source != cycleCacheSource) {
+		cycleCache.clear();
+		cycleCacheGeneration = generation;
+		cycleCacheScene = target2;
+		cycleCacheSource = source;
+	}
+	auto it = cycleCache.find(s);
+	if (it != cycleCache.end())
+		return it->second;
+
+	struct descendant_info info = {false, source, target2};
+	obs_source_enum_full_tree(s, check_descendant, &info);
+	cycleCache.emplace(s, info.exists);
+	return info.exists;
+}
+
+void CanvasDock::AddSourcesToMenu(QMenu *menu, std::vector<OBSSource> &sources)
+{
+	std::vector<std::pair<QString, OBSSource>> entries;
+	entries.reserve(sources.size());
+	for (auto &s : sources)
+		entries.emplace_back(QString::fromUtf8(obs_source_get_name(s)), s);
+	std::sort(entries.begin(), entries.end(),
+		  [](const auto &a, const auto &b) { return a.first.compare(b.first, Qt::CaseInsensitive) < 0; });
+
+	for (auto &entry : entries) {
+		auto na = new QAction(entry.first, menu);
+		OBSWeakSource weak = OBSGetWeakRef(entry.second);
+		connect(
+			na, &QAction::triggered, this,
+			[this, weak] {
+				OBSSourceAutoRelease s = obs_weak_source_get_source(weak);
+				if (s)
+					AddSourceToScene(s);
+			},
+			Qt::QueuedConnection);
+		na->setEnabled(!WouldCreateCycle(entry.second));
+		menu->addAction(na);
+	}
+}
+
 void CanvasDock::LoadSourceTypeMenu(QMenu *menu, const char *type)
 {
 	menu->clear();
+	struct source_type_collect collect = {type, {}};
 	if (obs_get_source_output_flags(type) & OBS_SOURCE_REQUIRES_CANVAS) {
+		struct canvas_menu_info {
+			CanvasDock *cd;
+			QMenu *menu;
+			const char *type;
+		} cmi = {this, menu, type};
 		obs_enum_canvases(
 			[](void *param, obs_canvas_t *canvas) {
-				QMenu *m = (QMenu *)param;
-				auto canvas_name = QString::fromUtf8(obs_canvas_get_name(canvas));
-				auto cm = m->addMenu(canvas_name);
-				obs_canvas_enum_scenes(canvas, add_sources_of_type_to_menu, cm);
+				auto *i = static_cast<struct canvas_menu_info *>(param);
+				auto cm = i->menu->addMenu(QString::fromUtf8(obs_canvas_get_name(canvas)));
+				struct source_type_collect c = {i->type, {}};
+				obs_canvas_enum_scenes(canvas, collect_sources_of_type, &c);
+				i->cd->AddSourcesToMenu(cm, c.sources);
 				return true;
 			},
-			menu);
+			&cmi);
 	} else if (strcmp(type, "scene") == 0) {
-		obs_enum_scenes(add_sources_of_type_to_menu, menu);
+		obs_enum_scenes(collect_sources_of_type, &collect);
+		AddSourcesToMenu(menu, collect.sources);
 	} else {
-		obs_enum_sources(add_sources_of_type_to_menu, menu);
+		source_index_enum_type(type, collect_sources_of_type, &collect);
+		AddSourcesToMenu(menu, collect.sources);
 
 		auto popupItem = new QAction(QString::fromUtf8(obs_frontend_get_locale_string("New")), menu);
 		popupItem->setData(QString::fromUtf8(type));
@@ -5117,7 +6012,7 @@ bool CanvasDock::StartVideo()
 	obs_frontend_canvas_list cl = {};
 	obs_frontend_get_canvases(&cl);
 	for (size_t i = 0; i < cl.canvases.num; i++) {
-		if (strcmp(obs_canvas_get_name(cl.canvases.array[i]), CANVAS_NAME) == 0 &&
+		if (strcmp(obs_canvas_get_name(cl.canvases.array[i]), canvas_name.c_str()) == 0 &&
 		    !obs_canvas_removed(cl.canvases.array[i])) {
 			c = obs_canvas_get_ref(cl.canvases.array[i]);
 			break;
@@ -5127,11 +6022,11 @@ bool CanvasDock::StartVideo()
 	if (canvas) {
 		obs_canvas_release(canvas);
 	}
-	canvas = c ? c : obs_frontend_add_canvas(CANVAS_NAME, nullptr, PROGRAM);
+	canvas = c ? c : obs_frontend_add_canvas(canvas_name.c_str(), nullptr, PROGRAM);
 	auto ph = obs_get_proc_handler();
 	calldata_t cd2 = {0};
 	calldata_set_ptr(&cd2, "canvas", canvas);
-	calldata_set_string(&cd2, "canvas_name", CANVAS_NAME);
+	calldata_set_string(&cd2, "canvas_name", canvas_name.c_str());
 	calldata_set_ptr(&cd2, "get_transitions", (void *)CanvasDock::get_transitions);
 	calldata_set_ptr(&cd2, "get_transitions_data", this);
 	proc_handler_call(ph, "downstream_keyer_add_canvas", &cd2);
@@ -5342,7 +6237,7 @@ void CanvasDock::ConfigButtonClicked()
 
 void CanvasDock::ReplayButtonClicked(QString filename)
 {
-	if (!obs_output_active(replayOutput)) {
+	if (!BacktrackActive()) {
 		if (replayButton->isChecked()) {
 			replayButton->setChecked(false);
 		}
@@ -5351,24 +6246,96 @@ void CanvasDock::ReplayButtonClicked(QString filename)
 	if (!replayButton->isChecked()) {
 		replayButton->setChecked(true);
 	}
+	SaveBacktrack(filename, 0);
+}
+
+void CanvasDock::SaveBacktrack(QString filename, int seconds)
+{
+	if (!BacktrackActive()) {
+		return;
+	}
+	if (obs_output_active(diskReplayOutput)) {
+		SaveDiskReplay(filename, seconds > 0 ? (uint32_t)seconds : 0);
+	} else {
+		// the replay buffer joins its previous save on the output thread, so only one save is handed to it at a time
+		BacktrackSave save;
+		save.filename = filename;
+		save.seconds = seconds > 0 ? (uint32_t)seconds : 0;
+		replaySaveQueue.push_back(save);
+		if (!replaySaving) {
+			StartNextReplaySave();
+		}
+	}
+
+	statusLabel->setText(QString::fromUtf8(obs_module_text("Saving")));
+	replayStatusResetTimer.start(10000);
+	SendVendorEvent("backtrack_saving");
+}
+
+void CanvasDock::ReplaySaveTimedOut()
+{
+	if (!replaySaving) {
+		return;
+	}
+	blog(LOG_WARNING, "[Vertical Canvas] backtrack save did not complete within %d seconds", REPLAY_SAVE_TIMEOUT_MS / 1000);
+	replaySaving = false;
+	statusLabel->setText(QString::fromUtf8(obs_module_text("SaveFailed")));
+	SendVendorEvent("backtrack_save_failed");
+	StartNextReplaySave();
+}
+
+void CanvasDock::StartNextReplaySave()
+{
+	replaySaveTimeoutTimer.stop();
+	if (replaySaveQueue.empty() || !obs_output_active(replayOutput)) {
+		replaySaving = false;
+		replaySaveQueue.clear();
+		return;
+	}
+	const BacktrackSave save = replaySaveQueue.front();
+	replaySaveQueue.pop_front();
+	if (save.seconds && save.seconds < replayDuration) {
+		blog(LOG_INFO, "[Vertical Canvas] backtrack in memory saves the full %u seconds instead of the last %u",
+		     replayDuration, save.seconds);
+	}
+
 	obs_data_t *s = obs_output_get_settings(replayOutput);
-	if (!filename.isEmpty()) {
+	if (!save.filename.isEmpty()) {
 		if (replayFilename.empty()) {
 			replayFilename = obs_data_get_string(s, "format");
 		}
-		obs_data_set_string(s, "format", filename.toUtf8().constData());
+		obs_data_set_string(s, "format", save.filename.toUtf8().constData());
 	} else if (!replayFilename.empty()) {
 		obs_data_set_string(s, "format", replayFilename.c_str());
 	}
 	obs_data_release(s);
+
+	replaySaving = true;
+	replaySaveStart = os_gettime_ns();
+	replaySaveSeconds = replayDuration;
+	// the replay buffer emits nothing when a save fails or the buffer is empty, so the queue must not wait forever
+	replaySaveTimeoutTimer.start(REPLAY_SAVE_TIMEOUT_MS);
 	calldata_t cd = {0};
 	proc_handler_t *ph = obs_output_get_proc_handler(replayOutput);
 	proc_handler_call(ph, "save", &cd);
 	calldata_free(&cd);
+}
 
-	statusLabel->setText(QString::fromUtf8(obs_module_text("Saving")));
-	replayStatusResetTimer.start(10000);
-	SendVendorEvent("backtrack_saving");
+void CanvasDock::SendBacktrackSaveCompleted(const char *path, uint64_t bytes, uint64_t duration_ns, uint32_t seconds)
+{
+	const double elapsed = (double)duration_ns / 1000000000.0;
+	const double throughput = elapsed > 0.0 ? (double)bytes / elapsed : 0.0;
+	blog(LOG_INFO, "[Vertical Canvas] backtrack saved to '%s' (%llu bytes in %.0f ms, %.1f MB/s)", path,
+	     (unsigned long long)bytes, elapsed * 1000.0, throughput / (1024.0 * 1024.0));
+
+	const auto d = obs_data_create();
+	obs_data_set_string(d, "path", path);
+	obs_data_set_int(d, "seconds", seconds);
+	obs_data_set_int(d, "bytes", (long long)bytes);
+	obs_data_set_int(d, "duration_ms", (long long)(duration_ns / 1000000));
+	obs_data_set_double(d, "throughput_bytes_per_sec", throughput);
+	SendVendorEvent("backtrack_save_completed", d);
+	obs_data_release(d);
 }
 
 int GetConfigPath(char *path, size_t size, const char *name)
@@ -5448,6 +6415,34 @@ void CanvasDock::RecordButtonClicked()
 	}
 }
 
+static std::string set_muxer_option(const std::string &muxer_settings, const char *name, const std::string &value)
+{
+	std::string result;
+	const std::string prefix = std::string(name) + "=";
+	size_t pos = 0;
+	while (pos < muxer_settings.size()) {
+		size_t end = muxer_settings.find(' ', pos);
+		if (end == std::string::npos) {
+			end = muxer_settings.size();
+		}
+		const std::string option = muxer_settings.substr(pos, end - pos);
+		if (!option.empty() && option.compare(0, prefix.size(), prefix) != 0) {
+			if (!result.empty()) {
+				result += " ";
+			}
+			result += option;
+		}
+		pos = end + 1;
+	}
+	if (!value.empty()) {
+		if (!result.empty()) {
+			result += " ";
+		}
+		result += prefix + value;
+	}
+	return result;
+}
+
 void CanvasDock::StartRecord()
 {
 	if (obs_output_active(recordOutput)) {
@@ -5601,9 +6596,30 @@ void CanvasDock::StartRecord()
 	obs_data_set_bool(ps, "split_file", true);
 	obs_data_set_int(ps, "max_size_mb", max_size_mb);
 	obs_data_set_int(ps, "max_time_sec", max_time_sec);
+	if (strcmp(obs_output_get_id(recordOutput), "mp4_output") == 0) {
+		// the native mp4 output writes through a buffered file serializer, which coalesces packets into chunk sized writes
+		obs_data_t *rs = obs_output_get_settings(recordOutput);
+		std::string muxer_settings = obs_data_get_string(rs, "muxer_settings");
+		obs_data_release(rs);
+		const uint32_t chunk_mb = record_write_buffer_mb >= 4 ? record_write_buffer_mb / 4 : 1;
+		muxer_settings = set_muxer_option(muxer_settings, "buffer_size",
+						  record_write_buffer_mb ? std::to_string(record_write_buffer_mb) : "");
+		muxer_settings =
+			set_muxer_option(muxer_settings, "chunk_size", record_write_buffer_mb ? std::to_string(chunk_mb) : "");
+		obs_data_set_string(ps, "muxer_settings", muxer_settings.c_str());
+	}
 	obs_output_update(recordOutput, ps);
 	obs_data_release(ps);
 
+	uint64_t planned_size = (uint64_t)max_size_mb * 1024 * 1024;
+	if (!planned_size && max_time_sec) {
+		planned_size = (uint64_t)(recordVideoBitrate + audioBitrate) * 1000 / 8 * max_time_sec;
+	}
+	if (planned_size && os_get_free_disk_space(dir) < planned_size) {
+		blog(LOG_WARNING, "[Vertical Canvas] less free disk space in '%s' than one %llu MB recording segment", dir,
+		     (unsigned long long)(planned_size / (1024 * 1024)));
+	}
+
 	SendVendorEvent("recording_starting");
 	const bool success = obs_output_start(recordOutput);
 	if (!success) {
@@ -5612,6 +6628,9 @@ void CanvasDock::StartRecord()
 		if (started_video) {
 			DestroyVideo();
 		}
+	} else {
+		LogAudioEncoderGraph(recordOutput);
+		StartDerivedRecord();
 	}
 }
 
@@ -5622,12 +6641,14 @@ void CanvasDock::StopRecord()
 		SendVendorEvent("recording_stopping");
 		obs_output_stop(recordOutput);
 	}
+	StopDerivedRecord();
 }
 
 void CanvasDock::record_output_start(void *data, calldata_t *calldata)
 {
 	UNUSED_PARAMETER(calldata);
 	auto d = static_cast<CanvasDock *>(data);
+	d->recordStartTime = os_gettime_ns();
 	d->SendVendorEvent("recording_started");
 	d->CheckReplayBuffer(true);
 	QMetaObject::invokeMethod(d, "OnRecordStart");
@@ -5658,7 +6679,110 @@ void CanvasDock::replay_saved(void *data, calldata_t *calldata)
 	QMetaObject::invokeMethod(d, "OnReplaySaved");
 }
 
-void CanvasDock::SetRecordAudioEncoders(obs_output_t *output)
+static bool audio_settings_match(obs_data_t *encoder_settings, obs_data_t *wanted)
+{
+	for (obs_data_item_t *item = obs_data_first(wanted); item; obs_data_item_next(&item)) {
+		const char *name = obs_data_item_get_name(item);
+		bool match = true;
+		switch (obs_data_item_gettype(item)) {
+		case OBS_DATA_NUMBER:
+			match = obs_data_get_double(encoder_settings, name) == obs_data_item_get_double(item);
+			break;
+		case OBS_DATA_STRING:
+			match = strcmp(obs_data_get_string(encoder_settings, name), obs_data_item_get_string(item)) == 0;
+			break;
+		case OBS_DATA_BOOLEAN:
+			match = obs_data_get_bool(encoder_settings, name) == obs_data_item_get_bool(item);
+			break;
+		default:
+			break;
+		}
+		if (!match) {
+			obs_data_item_release(&item);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool output_uses_audio_encoder(obs_output_t *output, obs_encoder_t *enc)
+{
+	for (size_t idx = 0; output && idx < MAX_AUDIO_MIXES; idx++) {
+		if (obs_output_get_audio_encoder(output, idx) == enc)
+			return true;
+	}
+	return false;
+}
+
+// audio is the same obs_get_audio() mix for every canvas, so an active main encoder with the same codec, settings and
+// track produces identical packets. pausing acts per encoder, so only the main stream encoders are shared: the main
+// replay buffer always shares its encoders with the main recording, and so does the stream in simple mode when the
+// recording quality is "Stream"
+static obs_encoder_t *find_main_audio_encoder(const char *id, obs_data_t *settings, size_t mixer_idx)
+{
+	config_t *config = obs_frontend_get_profile_config();
+	if (config && astrcmpi(config_get_string(config, "Output", "Mode"), "Advanced") != 0 &&
+	    astrcmpi(config_get_string(config, "SimpleOutput", "RecQuality"), "Stream") == 0)
+		return nullptr;
+
+	obs_output_t *stream_output = obs_frontend_get_streaming_output();
+	if (!stream_output)
+		return nullptr;
+	obs_output_t *record_output = obs_frontend_get_recording_output();
+	obs_encoder_t *found = nullptr;
+	for (size_t idx = 0; !found && idx < MAX_AUDIO_MIXES; idx++) {
+		obs_encoder_t *enc = obs_output_get_audio_encoder(stream_output, idx);
+		if (!enc || !obs_encoder_active(enc) || strcmp(obs_encoder_get_id(enc), id) != 0 ||
+		    obs_encoder_get_mixer_index(enc) != mixer_idx || output_uses_audio_encoder(record_output, enc))
+			continue;
+		obs_data_t *s = obs_encoder_get_settings(enc);
+		if (audio_settings_match(s, settings))
+			found = enc;
+		obs_data_release(s);
+	}
+	obs_output_release(record_output);
+	obs_output_release(stream_output);
+	return found;
+}
+
+static bool log_output_audio_encoders(void *param, obs_output_t *output)
+{
+	auto users = static_cast<std::map<obs_encoder_t *, std::vector<std::string>> *>(param);
+	if ((obs_output_get_flags(output) & OBS_OUTPUT_ENCODED) == 0)
+		return true;
+	const size_t count = (obs_output_get_flags(output) & OBS_OUTPUT_MULTI_TRACK) != 0 ? MAX_AUDIO_MIXES : 1;
+	for (size_t idx = 0; idx < count; idx++) {
+		obs_encoder_t *enc = obs_output_get_audio_encoder(output, idx);
+		if (enc)
+			(*users)[enc].push_back(obs_output_get_name(output));
+	}
+	return true;
+}
+
+void CanvasDock::LogAudioEncoderGraph(obs_output_t *output)
+{
+	if (!output)
+		return;
+	std::map<obs_encoder_t *, std::vector<std::string>> users;
+	obs_enum_outputs(log_output_audio_encoders, &users);
+	const size_t count = (obs_output_get_flags(output) & OBS_OUTPUT_MULTI_TRACK) != 0 ? MAX_AUDIO_MIXES : 1;
+	for (size_t idx = 0; idx < count; idx++) {
+		obs_encoder_t *enc = obs_output_get_audio_encoder(output, idx);
+		if (!enc)
+			continue;
+		std::string shared;
+		for (const auto &name : users[enc]) {
+			if (!shared.empty())
+				shared += ", ";
+			shared += name;
+		}
+		blog(LOG_INFO, "[Vertical Canvas] '%s' audio track %d: encoder '%s' (%s, mixer %d) used by %s",
+		     obs_output_get_name(output), (int)idx + 1, obs_encoder_get_name(enc), obs_encoder_get_id(enc),
+		     (int)obs_encoder_get_mixer_index(enc) + 1, shared.c_str());
+	}
+}
+
+void CanvasDock::SetRecordAudioEncoders(obs_output_t *output, bool share_main)
 {
 	size_t idx = 0;
 	if (record_advanced_settings) {
@@ -5735,12 +6859,21 @@ void CanvasDock::SetRecordAudioEncoders(obs_output_t *output)
 				}
 				aef = obs_output_get_audio_encoder(main_output, idx);
 			}
-			if (aef) {
+			obs_encoder_t *shared = nullptr;
+			if (aef && share_main) {
+				auto s = obs_encoder_get_settings(aef);
+				shared = find_main_audio_encoder(obs_encoder_get_id(aef), s, i);
+				obs_data_release(s);
+			}
+			if (shared) {
+				obs_output_set_audio_encoder(output, shared, idx);
+				idx++;
+			} else if (aef) {
 				obs_encoder_t *aet = obs_output_get_audio_encoder(replayOutput, idx);
 				if (!aet && recordOutput) {
 					aet = obs_output_get_audio_encoder(recordOutput, idx);
 				}
-				if (aet && strcmp(obs_encoder_get_id(aef), obs_encoder_get_id(aet)) != 0) {
+				if (aet && (aet == aef || strcmp(obs_encoder_get_id(aef), obs_encoder_get_id(aet)) != 0)) {
 					aet = nullptr;
 				}
 				if (!aet) {
@@ -5787,7 +6920,7 @@ void CanvasDock::ShowNoReplayOutputError()
 
 void CanvasDock::StartReplayBuffer()
 {
-	if (obs_output_active(replayOutput)) {
+	if (BacktrackActive()) {
 		return;
 	}
 
@@ -5898,15 +7031,23 @@ void CanvasDock::StartReplayBuffer()
 		obs_output_update(replayOutput, nullptr);
 	}
 
-	SetRecordAudioEncoders(replayOutput);
-
+	obs_output_t *output = replayOutput;
+	if (replayDisk) {
+		output = PrepareDiskReplayOutput();
+		if (!output) {
+			return;
+		}
+	}
+
+	SetRecordAudioEncoders(output, true);
+
 	bool started_video = StartVideo();
 
 	bool enc_set = false;
 	if (recordOutput) {
 		auto re = obs_output_get_video_encoder(recordOutput);
 		if (re && obs_encoder_active(re)) {
-			obs_output_set_video_encoder(replayOutput, re);
+			obs_output_set_video_encoder(output, re);
 			enc_set = true;
 		}
 	}
@@ -5920,7 +7061,7 @@ void CanvasDock::StartReplayBuffer()
 					auto enc = obs_output_get_video_encoder2(streaming_output, idx);
 					if (enc && obs_encoder_active(enc) &&
 					    obs_encoder_video(enc) == obs_canvas_get_video(canvas)) {
-						obs_output_set_video_encoder(replayOutput, enc);
+						obs_output_set_video_encoder(output, enc);
 						enc_set = true;
 						break;
 					}
@@ -5931,10 +7072,10 @@ void CanvasDock::StartReplayBuffer()
 	}
 
 	if (!enc_set) {
-		obs_output_set_video_encoder(replayOutput, GetRecordVideoEncoder());
+		obs_output_set_video_encoder(output, GetRecordVideoEncoder());
 	}
 
-	signal_handler_t *signal = obs_output_get_signal_handler(replayOutput);
+	signal_handler_t *signal = obs_output_get_signal_handler(output);
 	signal_handler_disconnect(signal, "start", replay_output_start, this);
 	signal_handler_disconnect(signal, "stop", replay_output_stop, this);
 	signal_handler_connect(signal, "start", replay_output_start, this);
@@ -5942,18 +7083,104 @@ void CanvasDock::StartReplayBuffer()
 
 	SendVendorEvent("backtrack_starting");
 
-	const bool success = obs_output_start(replayOutput);
+	const bool success = obs_output_start(output);
 	if (!success) {
 		QMetaObject::invokeMethod(this, "OnReplayBufferStop", Q_ARG(int, OBS_OUTPUT_ERROR),
-					  Q_ARG(QString, QString::fromUtf8(obs_output_get_last_error(replayOutput))));
+					  Q_ARG(QString, QString::fromUtf8(obs_output_get_last_error(output))));
 		if (started_video) {
 			DestroyVideo();
 		}
 	} else {
+		LogAudioEncoderGraph(output);
 		QMetaObject::invokeMethod(this, "OnReplayBufferStart");
 	}
 }
 
+// keeps the backtrack window as fixed length mpegts segments on disk, so memory use does not grow with the duration
+obs_output_t *CanvasDock::PrepareDiskReplayOutput()
+{
+	if (replayPath.empty()) {
+		blog(LOG_WARNING, "[Vertical Canvas] error starting disk backtrack: no backtrack path set");
+		return nullptr;
+	}
+	if (!diskReplayOutput) {
+		const std::string name = dock_title + " Disk " + obs_module_text("Backtrack");
+		diskReplayOutput = obs_output_create("ffmpeg_muxer", name.c_str(), nullptr, nullptr);
+		auto sh = obs_output_get_signal_handler(diskReplayOutput);
+		signal_handler_connect(sh, "file_changed", disk_replay_file_changed, this);
+	}
+
+	const std::string directory = replayPath + "/.vertical-backtrack/" + dock_id;
+	backtrack_ring_destroy(diskReplayRing);
+	diskReplayRing = backtrack_ring_create(directory.c_str(), replayDuration, disk_replay_saved, this);
+
+	const char *format = "segment %CCYY-%MM-%DD %hh-%mm-%ss";
+	char *filename = os_generate_formatted_filename("ts", false, format);
+	const std::string path = directory + "/" + filename;
+	bfree(filename);
+
+	auto s = obs_data_create();
+	obs_data_set_string(s, "path", path.c_str());
+	obs_data_set_string(s, "directory", directory.c_str());
+	obs_data_set_string(s, "format", format);
+	obs_data_set_string(s, "extension", "ts");
+	obs_data_set_bool(s, "allow_spaces", false);
+	obs_data_set_bool(s, "split_file", true);
+	obs_data_set_bool(s, "reset_timestamps", false);
+	obs_data_set_int(s, "max_time_sec", DISK_BACKTRACK_SEGMENT_SEC);
+	obs_data_set_int(s, "max_size_mb", 0);
+	obs_output_update(diskReplayOutput, s);
+	obs_data_release(s);
+
+	backtrack_ring_segment_started(diskReplayRing, path.c_str());
+	return diskReplayOutput;
+}
+
+void CanvasDock::SaveDiskReplay(const QString &filename, uint32_t seconds)
+{
+	std::string format = filename.isEmpty() ? replayFilename : filename.toUtf8().constData();
+	if (format.empty()) {
+		format = "%CCYY-%MM-%DD %hh-%mm-%ss-backtrack";
+	}
+	char *f = os_generate_formatted_filename("ts", true, format.c_str());
+	const std::string path = replayPath + "/" + f;
+	bfree(f);
+
+	// the save is queued on the ring and picked up once the segment being written is closed
+	backtrack_ring_request_save(diskReplayRing, path.c_str(), seconds);
+	calldata_t cd = {0};
+	proc_handler_t *ph = obs_output_get_proc_handler(diskReplayOutput);
+	proc_handler_call(ph, "split_file", &cd);
+	calldata_free(&cd);
+}
+
+void CanvasDock::disk_replay_file_changed(void *data, calldata_t *calldata)
+{
+	auto d = static_cast<CanvasDock *>(data);
+	const char *next_file = calldata_string(calldata, "next_file");
+	if (d->diskReplayRing && next_file) {
+		backtrack_ring_segment_started(d->diskReplayRing, next_file);
+	}
+}
+
+void CanvasDock::disk_replay_saved(void *param, const char *path, bool success, uint64_t bytes, uint64_t duration_ns,
+				   uint32_t seconds)
+{
+	auto d = static_cast<CanvasDock *>(param);
+	if (!success) {
+		return;
+	}
+	// called from the ring worker thread
+	QMetaObject::invokeMethod(
+		d,
+		[d, file = QString::fromUtf8(path), bytes, duration_ns, seconds] {
+			d->SendVendorEvent("backtrack_saved");
+			d->SendBacktrackSaveCompleted(file.toUtf8().constData(), bytes, duration_ns, seconds);
+			d->OnBacktrackFileSaved(file);
+		},
+		Qt::QueuedConnection);
+}
+
 #define SIMPLE_ENCODER_X264 "x264"
 #define SIMPLE_ENCODER_X264_LOWCPU "x264_lowcpu"
 #define SIMPLE_ENCODER_QSV "qsv"
@@ -6138,6 +7365,9 @@ obs_encoder_t *CanvasDock::GetStreamVideoEncoder()
 
 	obs_encoder_t *se = nullptr;
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		if (it->adaptive_bitrate) {
+			continue;
+		}
 		se = obs_output_get_video_encoder(it->output);
 		if (se) {
 			break;
@@ -6215,6 +7445,12 @@ obs_encoder_t *CanvasDock::GetRecordVideoEncoder()
 			video_encoder = re;
 		}
 	}
+	if (!video_encoder && diskReplayOutput) {
+		auto re = obs_output_get_video_encoder(diskReplayOutput);
+		if (re && strcmp(enc_id, obs_encoder_get_id(re)) == 0) {
+			video_encoder = re;
+		}
+	}
 	if (!video_encoder && recordOutput) {
 		auto re = obs_output_get_video_encoder(recordOutput);
 		if (re && strcmp(enc_id, obs_encoder_get_id(re)) == 0) {
@@ -6274,6 +7510,10 @@ void CanvasDock::StopReplayBuffer()
 		SendVendorEvent("backtrack_stopping");
 		obs_output_stop(replayOutput);
 	}
+	if (obs_output_active(diskReplayOutput)) {
+		SendVendorEvent("backtrack_stopping");
+		obs_output_stop(diskReplayOutput);
+	}
 }
 
 void CanvasDock::replay_output_start(void *data, calldata_t *calldata)
@@ -6303,7 +7543,7 @@ void CanvasDock::StreamButtonClicked()
 			active_count++;
 		}
 	}
-	if (active_count > 0) {
+	if (active_count > 0 || streamStartBatch) {
 		StopStream();
 		return;
 	}
@@ -6342,6 +7582,12 @@ void CanvasDock::StreamButtonMultiMenu(QMenu *menu)
 
 void CanvasDock::StartStreamOutput(std::vector<StreamServer>::iterator it)
 {
+	it->reconnect_pending = false;
+	if (!it->was_live) {
+		// a fresh start begins at the configured rate, a reconnect resumes at the adapted one
+		it->configured_bitrate = 0;
+		it->current_bitrate = 0;
+	}
 	CreateStreamOutput(it);
 	const bool started_video = StartVideo();
 	if (it->settings && obs_data_get_bool(it->settings, "advanced") && obs_get_module("aitum-multistream")) {
@@ -6349,7 +7595,7 @@ void CanvasDock::StartStreamOutput(std::vector<StreamServer>::iterator it)
 		auto venc_name = obs_data_get_string(it->settings, "video_encoder");
 		if (!venc_name || venc_name[0] == '\0') {
 			//use main encoder
-			obs_output_set_video_encoder(it->output, GetStreamVideoEncoder());
+			obs_output_set_video_encoder(it->output, GetAdaptiveVideoEncoder(it, GetStreamVideoEncoder()));
 		} else {
 			obs_data_t *s = nullptr;
 			auto ves = obs_data_get_obj(it->settings, "video_encoder_settings");
@@ -6412,29 +7658,37 @@ void CanvasDock::StartStreamOutput(std::vector<StreamServer>::iterator it)
 				obs_data_apply(s, aes);
 				obs_data_release(aes);
 			}
-			std::string audio_encoder_name = "vertical_canvas_audio_encoder_";
-			audio_encoder_name += it->name;
-			auto aenc = obs_audio_encoder_create(aenc_name, audio_encoder_name.c_str(), s,
-							     obs_data_get_int(it->settings, "audio_track"), nullptr);
+			const size_t audio_track = (size_t)obs_data_get_int(it->settings, "audio_track");
+			auto aenc = s ? find_main_audio_encoder(aenc_name, s, audio_track) : nullptr;
+			if (!aenc) {
+				std::string audio_encoder_name = "vertical_canvas_audio_encoder_";
+				audio_encoder_name += it->name;
+				aenc = obs_audio_encoder_create(aenc_name, audio_encoder_name.c_str(), s, audio_track, nullptr);
+				obs_encoder_set_audio(aenc, obs_get_audio());
+			}
 			obs_data_release(s);
-			obs_encoder_set_audio(aenc, obs_get_audio());
 			obs_output_set_audio_encoder(it->output, aenc, 0);
 		}
 	} else {
 		blog(LOG_INFO, "[Vertical Canvas] Start output '%s'", it->name.c_str());
-		obs_output_set_video_encoder(it->output, GetStreamVideoEncoder());
+		obs_output_set_video_encoder(it->output, GetAdaptiveVideoEncoder(it, GetStreamVideoEncoder()));
 		obs_output_set_audio_encoder(it->output, GetStreamAudioEncoder(), 0);
 	}
 	it->stopping = false;
+	it->start_time = os_gettime_ns();
+	it->first_packet_ms = -1;
 	if (!obs_output_start(it->output)) {
 		if (started_video) {
 			DestroyVideo();
 		}
 		it->stopping = true;
+		it->start_time = 0;
 		QMetaObject::invokeMethod(this, "OnStreamStop", Q_ARG(int, OBS_OUTPUT_ERROR),
 					  Q_ARG(QString, QString::fromUtf8(obs_output_get_last_error(it->output))),
 					  Q_ARG(QString, QString::fromUtf8(it->stream_server)),
 					  Q_ARG(QString, QString::fromUtf8(it->stream_key)));
+	} else {
+		LogAudioEncoderGraph(it->output);
 	}
 }
 
@@ -6501,6 +7755,8 @@ void CanvasDock::CreateStreamOutput(std::vector<StreamServer>::iterator it)
 		it->output = obs_output_create(type, name.c_str(), nullptr, nullptr);
 		obs_output_set_service(it->output, it->service);
 	}
+	// reconnects are driven by the per target policy in ScheduleStreamReconnect
+	obs_output_set_reconnect_settings(it->output, 0, 0);
 	config_t *config = obs_frontend_get_profile_config();
 	if (config) {
 		OBSDataAutoRelease output_settings = obs_data_create();
@@ -6586,10 +7842,18 @@ obs_encoder_t *CanvasDock::GetStreamAudioEncoder()
 			obs_data_set_int(audio_settings, "bitrate", audioBitrate);
 		}
 	}
-	obs_encoder_t *audio_encoder = nullptr;
+	obs_encoder_t *audio_encoder = find_main_audio_encoder("ffmpeg_aac", audio_settings, mix_idx);
+	if (audio_encoder) {
+		blog(LOG_INFO, "[Vertical Canvas] Sharing audio encoder '%s' with main output", obs_encoder_get_name(audio_encoder));
+		obs_data_release(audio_settings);
+		return audio_encoder;
+	}
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
 		if (!audio_encoder) {
 			audio_encoder = obs_output_get_audio_encoder(it->output, 0);
+			if (audio_encoder && strcmp(obs_encoder_get_name(audio_encoder), "vertical_canvas_audio_encoder") != 0) {
+				audio_encoder = nullptr;
+			}
 		}
 	}
 	if (!audio_encoder) {
@@ -6597,7 +7861,9 @@ obs_encoder_t *CanvasDock::GetStreamAudioEncoder()
 			obs_audio_encoder_create("ffmpeg_aac", "vertical_canvas_audio_encoder", audio_settings, mix_idx, nullptr);
 		obs_encoder_set_audio(audio_encoder, obs_get_audio());
 		for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
-			obs_output_set_audio_encoder(it->output, audio_encoder, 0);
+			if (!obs_output_active(it->output)) {
+				obs_output_set_audio_encoder(it->output, audio_encoder, 0);
+			}
 		}
 	} else {
 		obs_encoder_update(audio_encoder, audio_settings);
@@ -6608,6 +7874,9 @@ obs_encoder_t *CanvasDock::GetStreamAudioEncoder()
 
 void CanvasDock::StartStream()
 {
+	if (streamStartBatch) {
+		return;
+	}
 	bool to_start = false;
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
 		if (obs_output_active(it->output)) {
@@ -6629,6 +7898,473 @@ void CanvasDock::StartStream()
 		return;
 	}
 
+	// video teardown by another output while armed detaches the encoders, prepare again in that case
+	for (auto it = streamOutputs.begin(); streamArmed && it != streamOutputs.end(); ++it) {
+		if (it->enabled && (!it->output || !obs_encoder_video(obs_output_get_video_encoder(it->output)))) {
+			streamArmed = false;
+		}
+	}
+	bool started_video;
+	if (streamArmed) {
+		blog(LOG_INFO, "[Vertical Canvas] Start armed stream outputs");
+		started_video = streamArmedVideo;
+	} else {
+		started_video = PrepareStreamOutputs() || streamArmedVideo;
+	}
+	streamArmed = false;
+	streamArmedVideo = false;
+
+	SendVendorEvent("streaming_starting");
+
+	// targets are started from a queue so one slow ingest does not hold back the others
+	streamStartPending.clear();
+	streamStartFailures.clear();
+	streamStartConnecting = 0;
+	streamStartBatch = true;
+	streamStartVideo = started_video;
+	for (size_t i = 0; i < streamOutputs.size(); i++) {
+		streamOutputs[i].connecting = false;
+		if (streamOutputs[i].enabled) {
+			streamStartPending.push_back(i);
+		}
+	}
+	StartNextStreamOutputs();
+}
+
+void CanvasDock::StartNextStreamOutputs()
+{
+	if (!streamStartBatch || streamStartTimer.isActive()) {
+		return;
+	}
+	config_t *config = obs_frontend_get_profile_config();
+	while (!streamStartPending.empty() && (stream_start_parallel <= 0 || streamStartConnecting < stream_start_parallel)) {
+		const size_t idx = streamStartPending.front();
+		streamStartPending.pop_front();
+		if (idx >= streamOutputs.size() || !streamOutputs[idx].enabled || !streamOutputs[idx].output) {
+			continue;
+		}
+		auto it = streamOutputs.begin() + (long long)idx;
+		if (config) {
+			OBSDataAutoRelease output_settings = obs_data_create();
+			obs_data_set_string(output_settings, "bind_ip", config_get_string(config, "Output", "BindIP"));
+			obs_data_set_string(output_settings, "ip_family", config_get_string(config, "Output", "IPFamily"));
+			obs_output_update(it->output, output_settings);
+		}
+		it->stopping = false;
+		it->start_time = os_gettime_ns();
+		it->first_packet_ms = -1;
+		it->start_latency_ms = -1;
+		if (obs_output_start(it->output)) {
+			LogAudioEncoderGraph(it->output);
+			it->connecting = true;
+			streamStartConnecting++;
+		} else {
+			it->stopping = true;
+			it->start_time = 0;
+			const char *last_error = obs_output_get_last_error(it->output);
+			blog(LOG_WARNING, "[Vertical Canvas] Stream output '%s' failed to start: %s", it->name.c_str(),
+			     last_error ? last_error : "");
+			streamStartFailures.append(QString::fromUtf8(it->name.empty() ? it->stream_server : it->name) +
+						   QString::fromUtf8(": ") +
+						   QString::fromUtf8(obs_frontend_get_locale_string("Output.ConnectFail.Error")) +
+						   (last_error ? QString::fromUtf8("\n") + QString::fromUtf8(last_error) : QString()));
+			continue;
+		}
+		if (stream_start_stagger_ms > 0 && !streamStartPending.empty()) {
+			streamStartTimer.start(stream_start_stagger_ms);
+			return;
+		}
+	}
+	CheckStreamStartBatch();
+}
+
+void CanvasDock::StreamOutputStarted(obs_output_t *output, uint64_t time)
+{
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		if (it->output != output) {
+			continue;
+		}
+		if (it->connecting) {
+			it->connecting = false;
+			streamStartConnecting--;
+		}
+		it->last_total_frames = 0;
+		it->last_dropped_frames = 0;
+		it->drop_ratio = 0.0;
+		it->bitrate_congested_ticks = 0;
+		it->bitrate_clear_ticks = 0;
+		it->live_since = time;
+		if (it->was_live && it->reconnect_attempt > 0) {
+			blog(LOG_INFO, "[Vertical Canvas] Stream output '%s' reconnected after %d attempt(s)", it->name.c_str(),
+			     it->reconnect_attempt);
+			auto extra = obs_data_create();
+			obs_data_set_string(extra, "name", it->name.c_str());
+			obs_data_set_int(extra, "attempt", it->reconnect_attempt);
+			SendVendorEvent("stream_reconnected", extra);
+			obs_data_release(extra);
+		} else if (!it->was_live) {
+			SendVendorEvent("streaming_started");
+		}
+		it->was_live = true;
+		if (it->start_time && it->start_latency_ms < 0) {
+			it->start_latency_ms = time > it->start_time ? (int64_t)((time - it->start_time) / 1000000) : 0;
+			blog(LOG_INFO, "[Vertical Canvas] Stream output '%s' started in %lld ms", it->name.c_str(),
+			     (long long)it->start_latency_ms);
+			auto extra = obs_data_create();
+			obs_data_set_string(extra, "name", it->name.c_str());
+			obs_data_set_int(extra, "start_latency_ms", it->start_latency_ms);
+			SendVendorEvent("stream_output_started", extra);
+			obs_data_release(extra);
+		}
+		break;
+	}
+	StartNextStreamOutputs();
+}
+
+void CanvasDock::CheckStreamStartBatch()
+{
+	if (!streamStartBatch || !streamStartPending.empty() || streamStartConnecting > 0 || streamStartTimer.isActive()) {
+		return;
+	}
+	streamStartBatch = false;
+	if (!StreamingActive()) {
+		if (streamStartVideo && !RecordingActive() && !BacktrackActive() && !VirtualCameraActive()) {
+			obs_canvas_set_channel(canvas, 0, nullptr);
+		}
+		streamButton->setChecked(false);
+		streamButton->setIcon(streamInactiveIcon);
+		streamButton->setText("");
+	}
+	streamStartVideo = false;
+	if (streamStartFailures.isEmpty()) {
+		return;
+	}
+	blog(LOG_WARNING, "[Vertical Canvas] %d stream output(s) failed to start", (int)streamStartFailures.size());
+	if (isVisible()) {
+		auto box = new QMessageBox(QMessageBox::Warning,
+					   QString::fromUtf8(obs_frontend_get_locale_string("Output.ConnectFail.Title")),
+					   streamStartFailures.join(QString::fromUtf8("\n\n")), QMessageBox::Ok, this);
+		box->setAttribute(Qt::WA_DeleteOnClose);
+		box->setModal(false);
+		box->show();
+	}
+	streamStartFailures.clear();
+}
+
+bool CanvasDock::ScheduleStreamReconnect(std::vector<StreamServer>::iterator it)
+{
+	if (it->reconnect_attempt >= it->reconnect_retries) {
+		blog(LOG_WARNING, "[Vertical Canvas] Stream output '%s' gave up reconnecting after %d attempt(s)", it->name.c_str(),
+		     it->reconnect_attempt);
+		it->was_live = false;
+		it->reconnect_attempt = 0;
+		return false;
+	}
+	static std::mt19937 rng{std::random_device{}()};
+	std::uniform_real_distribution<double> jitter(0.75, 1.25);
+	double delay = (double)it->reconnect_delay_sec * 1000.0 * (double)(1ULL << std::min(it->reconnect_attempt, 16));
+	delay = std::min(delay, (double)it->reconnect_max_delay_sec * 1000.0);
+	// an unhealthy target backs off further so a flapping ingest stays out of the way of the healthy ones
+	delay *= 1.0 + (100.0 - it->health) / 100.0;
+	delay *= jitter(rng);
+
+	it->reconnect_pending = true;
+	auto output = it->output;
+	QTimer::singleShot((int)delay, this, [this, output] { ReconnectStreamOutput(output); });
+
+	auto extra = obs_data_create();
+	obs_data_set_string(extra, "name", it->name.c_str());
+	obs_data_set_int(extra, "attempt", it->reconnect_attempt + 1);
+	obs_data_set_int(extra, "delay_ms", (long long)delay);
+	SendVendorEvent("stream_reconnecting", extra);
+	obs_data_release(extra);
+	return true;
+}
+
+void CanvasDock::ReconnectStreamOutput(obs_output_t *output)
+{
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		if (it->output != output || !it->reconnect_pending) {
+			continue;
+		}
+		it->reconnect_attempt++;
+		it->reconnect_history.push_back(os_gettime_ns());
+		blog(LOG_INFO, "[Vertical Canvas] Stream output '%s' reconnect attempt %d of %d", it->name.c_str(),
+		     it->reconnect_attempt, it->reconnect_retries);
+		StartStreamOutput(it);
+		return;
+	}
+}
+
+obs_encoder_t *CanvasDock::GetAdaptiveVideoEncoder(std::vector<StreamServer>::iterator it, obs_encoder_t *shared)
+{
+	if (!it->adaptive_bitrate || !shared) {
+		return shared;
+	}
+	// adaptive targets get their own copy of the stream encoder so a bitrate step only affects that target, the
+	// copy is made at start because an encoder cannot be swapped on an active output
+	std::string name = "vertical_canvas_video_encoder_";
+	name += it->name;
+	auto enc = obs_output_get_video_encoder(it->output);
+	if (enc && (name != obs_encoder_get_name(enc) || strcmp(obs_encoder_get_id(enc), obs_encoder_get_id(shared)) != 0)) {
+		enc = nullptr;
+	}
+	auto shared_settings = obs_encoder_get_settings(shared);
+	auto settings = obs_data_create();
+	obs_data_apply(settings, shared_settings);
+	obs_data_release(shared_settings);
+	if (it->configured_bitrate <= 0) {
+		it->configured_bitrate = (int)obs_data_get_int(settings, "bitrate");
+	}
+	int bitrate = it->current_bitrate > 0 ? it->current_bitrate : it->configured_bitrate;
+	if (it->bitrate_ceiling > 0) {
+		bitrate = std::min(bitrate, it->bitrate_ceiling);
+	}
+	if (bitrate > 0) {
+		obs_data_set_int(settings, "bitrate", bitrate);
+	}
+	if (!enc) {
+		enc = obs_video_encoder_create(obs_encoder_get_id(shared), name.c_str(), settings, nullptr);
+	} else if (!obs_encoder_active(enc)) {
+		obs_encoder_update(enc, settings);
+	}
+	obs_data_release(settings);
+	if (!obs_encoder_active(enc)) {
+		obs_encoder_set_preferred_video_format(enc, obs_encoder_get_preferred_video_format(shared));
+		obs_encoder_set_video(enc, obs_canvas_get_video(canvas));
+	}
+	return enc;
+}
+
+void CanvasDock::UpdateAdaptiveBitrate()
+{
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		if (!it->adaptive_bitrate || !obs_output_active(it->output)) {
+			continue;
+		}
+		auto enc = obs_output_get_video_encoder(it->output);
+		if (!enc || strncmp(obs_encoder_get_name(enc), "vertical_canvas_video_encoder_", 30) != 0) {
+			continue;
+		}
+		auto settings = obs_encoder_get_settings(enc);
+		if (!settings) {
+			continue;
+		}
+		const int bitrate = (int)obs_data_get_int(settings, "bitrate");
+		if (it->configured_bitrate <= 0) {
+			// the copy made at start records the configured rate, this only covers encoders from advanced settings
+			it->configured_bitrate = bitrate;
+		}
+		const int ceiling = it->bitrate_ceiling > 0 ? it->bitrate_ceiling : it->configured_bitrate;
+		const int floor = std::min(it->bitrate_floor > 0 ? it->bitrate_floor : ceiling / 4, ceiling);
+
+		// hysteresis, step down after a few congested seconds and only creep back up after a long clear stretch
+		const double congestion = (double)obs_output_get_congestion(it->output);
+		if (congestion > 0.5 || it->drop_ratio > 0.01) {
+			it->bitrate_congested_ticks++;
+			it->bitrate_clear_ticks = 0;
+		} else if (congestion < 0.1 && it->drop_ratio <= 0.0) {
+			it->bitrate_clear_ticks++;
+			it->bitrate_congested_ticks = 0;
+		} else {
+			it->bitrate_congested_ticks = 0;
+			it->bitrate_clear_ticks = 0;
+		}
+		int target = std::clamp(bitrate, floor, ceiling);
+		if (it->bitrate_congested_ticks >= 2) {
+			target = std::max(bitrate * 4 / 5, floor);
+			it->bitrate_congested_ticks = 0;
+		} else if (it->bitrate_clear_ticks >= 15) {
+			target = std::min(bitrate + std::max(ceiling / 10, 1), ceiling);
+			it->bitrate_clear_ticks = 0;
+		}
+		it->current_bitrate = target;
+		if (target != bitrate) {
+			blog(LOG_INFO, "[Vertical Canvas] Stream output '%s' bitrate %d -> %d kbps", it->name.c_str(), bitrate, target);
+			obs_data_set_int(settings, "bitrate", target);
+			obs_encoder_update(enc, nullptr);
+			auto extra = obs_data_create();
+			obs_data_set_string(extra, "name", it->name.c_str());
+			obs_data_set_int(extra, "bitrate", target);
+			SendVendorEvent("stream_bitrate_changed", extra);
+			obs_data_release(extra);
+		}
+		obs_data_release(settings);
+	}
+}
+
+obs_data_t *CanvasDock::SampleOutputStats(obs_output_t *output, uint64_t now)
+{
+	auto s = obs_data_create();
+	const bool active = obs_output_active(output);
+	obs_data_set_bool(s, "active", active);
+	if (!active) {
+		return s;
+	}
+	const uint64_t bytes = obs_output_get_total_bytes(output);
+	double kbps = 0.0;
+	auto last = statsOutputBytes.find(output);
+	if (last != statsOutputBytes.end() && bytes >= last->second.first && now > last->second.second) {
+		kbps = (double)(bytes - last->second.first) * 8.0 / ((double)(now - last->second.second) / 1000000.0);
+	}
+	statsOutputBytes[output] = {bytes, now};
+	obs_data_set_int(s, "total_bytes", (long long)bytes);
+	obs_data_set_double(s, "bitrate_kbps", kbps);
+	obs_data_set_double(s, "bytes_per_sec", kbps * 1000.0 / 8.0);
+	obs_data_set_int(s, "total_frames", obs_output_get_total_frames(output));
+	obs_data_set_int(s, "dropped_frames", obs_output_get_frames_dropped(output));
+	obs_data_set_double(s, "congestion", (double)obs_output_get_congestion(output));
+	return s;
+}
+
+void CanvasDock::SampleStats()
+{
+	const uint64_t now = os_gettime_ns();
+	auto s = obs_data_create();
+
+	auto c = obs_data_create();
+	video_t *video = canvas && obs_canvas_has_video(canvas) ? obs_canvas_get_video(canvas) : nullptr;
+	obs_data_set_bool(c, "active", video != nullptr);
+	if (video) {
+		obs_data_set_int(c, "total_frames", video_output_get_total_frames(video));
+		obs_data_set_int(c, "encoder_skipped_frames", video_output_get_skipped_frames(video));
+	}
+	// the vertical canvas renders on the shared graphics thread, so render lag is the global figure
+	obs_data_set_int(c, "render_total_frames", obs_get_total_frames());
+	obs_data_set_int(c, "render_lagged_frames", obs_get_lagged_frames());
+	obs_data_set_double(c, "average_frame_time_ms", (double)obs_get_average_frame_time_ns() / 1000000.0);
+	obs_data_set_obj(s, "canvas", c);
+	obs_data_release(c);
+
+	auto l = obs_data_create();
+	obs_data_set_int(l, "switches", (long long)linkedSwitchCount);
+	obs_data_set_int(l, "late_frames", (long long)linkedSwitchLateCount);
+	obs_data_set_double(l, "last_handler_ms", (double)linkedSwitchLastHandlerNs / 1000000.0);
+	obs_data_set_double(l, "max_handler_ms", (double)linkedSwitchMaxHandlerNs / 1000000.0);
+	obs_data_set_obj(s, "linked_switch", l);
+	obs_data_release(l);
+
+	auto outputs = obs_data_array_create();
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		auto o = SampleOutputStats(it->output, now);
+		obs_data_set_string(o, "name", it->name.c_str());
+		obs_data_set_bool(o, "enabled", it->enabled);
+		obs_data_set_int(o, "start_latency_ms", it->start_latency_ms);
+		obs_data_set_int(o, "time_to_first_packet_ms", it->first_packet_ms);
+		obs_data_set_double(o, "health", it->health);
+		obs_data_set_int(o, "video_bitrate", it->adaptive_bitrate ? it->current_bitrate : streamingVideoBitrate);
+		obs_data_set_bool(o, "reconnecting", it->reconnect_pending);
+		obs_data_set_int(o, "reconnect_attempt", it->reconnect_attempt);
+		obs_data_set_int(o, "recent_reconnects", (long long)it->reconnect_history.size());
+		obs_data_array_push_back(outputs, o);
+		obs_data_release(o);
+	}
+	obs_data_set_array(s, "stream_outputs", outputs);
+
+	auto r = SampleOutputStats(recordOutput, now);
+	if (obs_output_active(recordOutput)) {
+		const uint64_t elapsed = now > recordStartTime ? now - recordStartTime : 0;
+		obs_data_set_int(r, "duration_ms", (long long)(elapsed / 1000000));
+		obs_data_set_double(r, "average_bytes_per_sec",
+				    elapsed ? (double)obs_data_get_int(r, "total_bytes") * 1000000000.0 / (double)elapsed : 0.0);
+		obs_data_set_int(r, "write_buffer_mb", record_write_buffer_mb);
+	}
+	obs_data_set_obj(s, "record", r);
+	auto b = SampleOutputStats(obs_output_active(diskReplayOutput) ? diskReplayOutput : replayOutput, now);
+	obs_data_set_obj(s, "backtrack", b);
+
+	for (auto it = statsOutputBytes.begin(); it != statsOutputBytes.end();) {
+		if (it->second.second != now) {
+			it = statsOutputBytes.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (show_stats) {
+		QString text;
+		if (video) {
+			text += QString::fromUtf8("%1 %2/%3  %4 %5/%6\n")
+					.arg(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.MissedFrames")))
+					.arg(obs_get_lagged_frames())
+					.arg(obs_get_total_frames())
+					.arg(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.SkippedFrames")))
+					.arg(video_output_get_skipped_frames(video))
+					.arg(video_output_get_total_frames(video));
+		}
+		auto add_output_line = [&text](const QString &name, obs_data_t *o) {
+			if (!obs_data_get_bool(o, "active")) {
+				return;
+			}
+			text += QString::fromUtf8("%1: %2 kb/s  %3 %4\n")
+					.arg(name)
+					.arg((int)obs_data_get_double(o, "bitrate_kbps"))
+					.arg(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.DroppedFrames")))
+					.arg(obs_data_get_int(o, "dropped_frames"));
+		};
+		for (size_t i = 0; i < streamOutputs.size(); i++) {
+			auto o = obs_data_array_item(outputs, i);
+			add_output_line(QString::fromUtf8(streamOutputs[i].name.empty() ? streamOutputs[i].stream_server
+											   : streamOutputs[i].name),
+					o);
+			obs_data_release(o);
+		}
+		add_output_line(QString::fromUtf8(obs_frontend_get_locale_string("Basic.Stats.Output.Recording")), r);
+		add_output_line(QString::fromUtf8(obs_module_text("Backtrack")), b);
+		statsLabel->setText(text.trimmed());
+	}
+	obs_data_array_release(outputs);
+	obs_data_release(r);
+	obs_data_release(b);
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	obs_data_release(stats);
+	stats = s;
+}
+
+obs_data_t *CanvasDock::GetStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	if (!stats) {
+		return obs_data_create();
+	}
+	obs_data_addref(stats);
+	return stats;
+}
+
+void CanvasDock::UpdateStreamHealth()
+{
+	const uint64_t now = os_gettime_ns();
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		while (!it->reconnect_history.empty() && now - it->reconnect_history.front() > 600000000000ULL) {
+			it->reconnect_history.pop_front();
+		}
+		if (!obs_output_active(it->output)) {
+			continue;
+		}
+		if (it->reconnect_attempt && it->live_since && now - it->live_since > 60000000000ULL) {
+			it->reconnect_attempt = 0;
+		}
+		const uint64_t total = (uint64_t)obs_output_get_total_frames(it->output);
+		const uint64_t dropped = (uint64_t)obs_output_get_frames_dropped(it->output);
+		double drop_ratio = 0.0;
+		if (total > it->last_total_frames && dropped >= it->last_dropped_frames) {
+			drop_ratio = (double)(dropped - it->last_dropped_frames) / (double)(total - it->last_total_frames);
+		}
+		it->last_total_frames = total;
+		it->last_dropped_frames = dropped;
+		it->drop_ratio = drop_ratio;
+
+		double score = 100.0;
+		score -= (double)obs_output_get_congestion(it->output) * 40.0;
+		score -= std::min(drop_ratio * 400.0, 40.0);
+		score -= std::min((double)it->reconnect_history.size() * 10.0, 40.0);
+		it->health = it->health * 0.9 + std::clamp(score, 0.0, 100.0) * 0.1;
+	}
+}
+
+bool CanvasDock::PrepareStreamOutputs()
+{
 	obs_encoder_t *video_encoder = nullptr;
 	obs_encoder_t *audio_encoder = nullptr;
 	const bool started_video = StartVideo();
@@ -6655,7 +8391,7 @@ void CanvasDock::StartStream()
 				if (!video_encoder) {
 					video_encoder = GetStreamVideoEncoder();
 				}
-				obs_output_set_video_encoder(it->output, video_encoder);
+				obs_output_set_video_encoder(it->output, GetAdaptiveVideoEncoder(it, video_encoder));
 			} else {
 				obs_data_t *ves_apply = nullptr;
 				auto ves = obs_data_get_obj(it->settings, "video_encoder_settings");
@@ -6721,12 +8457,16 @@ void CanvasDock::StartStream()
 					obs_data_apply(aes_apply, aes);
 					obs_data_release(aes);
 				}
-				std::string audio_encoder_name = "vertical_canvas_audio_encoder_";
-				audio_encoder_name += it->name;
-				auto aenc = obs_audio_encoder_create(aenc_name, audio_encoder_name.c_str(), aes_apply,
-								     obs_data_get_int(it->settings, "audio_track"), nullptr);
+				const size_t audio_track = (size_t)obs_data_get_int(it->settings, "audio_track");
+				auto aenc = aes_apply ? find_main_audio_encoder(aenc_name, aes_apply, audio_track) : nullptr;
+				if (!aenc) {
+					std::string audio_encoder_name = "vertical_canvas_audio_encoder_";
+					audio_encoder_name += it->name;
+					aenc = obs_audio_encoder_create(aenc_name, audio_encoder_name.c_str(), aes_apply, audio_track,
+									nullptr);
+					obs_encoder_set_audio(aenc, obs_get_audio());
+				}
 				obs_data_release(aes_apply);
-				obs_encoder_set_audio(aenc, obs_get_audio());
 				obs_output_set_audio_encoder(it->output, aenc, 0);
 			}
 		} else {
@@ -6734,120 +8474,423 @@ void CanvasDock::StartStream()
 			if (!video_encoder) {
 				video_encoder = GetStreamVideoEncoder();
 			}
-			obs_output_set_video_encoder(it->output, video_encoder);
+			obs_output_set_video_encoder(it->output, GetAdaptiveVideoEncoder(it, video_encoder));
 			if (!audio_encoder) {
 				audio_encoder = GetStreamAudioEncoder();
 			}
 			obs_output_set_audio_encoder(it->output, audio_encoder, 0);
 		}
 	}
+	return started_video;
+}
 
-	SendVendorEvent("streaming_starting");
+void CanvasDock::ArmStream()
+{
+	if (streamArmed || StreamingActive()) {
+		return;
+	}
+	bool to_arm = false;
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		if (it->enabled) {
+			to_arm = true;
+		}
+	}
+	if (!to_arm) {
+		blog(LOG_WARNING, "[Vertical Canvas] No stream output to arm");
+		return;
+	}
+	// outputs and encoders are created and attached now so going live only has to connect
+	streamArmedVideo = PrepareStreamOutputs();
+	streamArmed = true;
+	blog(LOG_INFO, "[Vertical Canvas] Stream outputs armed");
+	SendVendorEvent("streaming_armed");
+}
 
-	config_t *config = obs_frontend_get_profile_config();
-	bool success = false;
+void CanvasDock::DisarmStream()
+{
+	if (!streamArmed) {
+		return;
+	}
+	streamArmed = false;
+	if (streamArmedVideo && !StreamingActive() && !RecordingActive() && !BacktrackActive() && !VirtualCameraActive()) {
+		obs_canvas_set_channel(canvas, 0, nullptr);
+	}
+	streamArmedVideo = false;
+	blog(LOG_INFO, "[Vertical Canvas] Stream outputs disarmed");
+	SendVendorEvent("streaming_disarmed");
+}
+
+void CanvasDock::CheckStreamFirstPacket()
+{
+	bool waiting = false;
+	const uint64_t now = os_gettime_ns();
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
-		if (!it->enabled) {
+		if (!it->start_time || it->first_packet_ms >= 0 || !obs_output_active(it->output)) {
 			continue;
 		}
-		if (config) {
-			OBSDataAutoRelease output_settings = obs_data_create();
-			obs_data_set_string(output_settings, "bind_ip", config_get_string(config, "Output", "BindIP"));
-			obs_data_set_string(output_settings, "ip_family", config_get_string(config, "Output", "IPFamily"));
-			obs_output_update(it->output, output_settings);
-		}
-		it->stopping = false;
-		if (obs_output_start(it->output)) {
-			success = true;
-		} else {
-			it->stopping = true;
-			QMetaObject::invokeMethod(this, "OnStreamStop", Q_ARG(int, OBS_OUTPUT_ERROR),
-						  Q_ARG(QString, QString::fromUtf8(obs_output_get_last_error(it->output))),
-						  Q_ARG(QString, QString::fromUtf8(it->stream_server)),
-						  Q_ARG(QString, QString::fromUtf8(it->stream_key)));
+		if (!obs_output_get_total_bytes(it->output)) {
+			if (now - it->start_time < 60000000000ULL) {
+				waiting = true;
+			}
+			continue;
 		}
+		it->first_packet_ms = (int64_t)((now - it->start_time) / 1000000);
+		blog(LOG_INFO, "[Vertical Canvas] Stream output '%s' first packet after %lld ms", it->name.c_str(),
+		     (long long)it->first_packet_ms);
+		auto extra = obs_data_create();
+		obs_data_set_string(extra, "name", it->name.c_str());
+		obs_data_set_int(extra, "time_to_first_packet_ms", it->first_packet_ms);
+		SendVendorEvent("stream_first_packet", extra);
+		obs_data_release(extra);
 	}
-	if (!success && started_video) {
-		obs_canvas_set_channel(canvas, 0, nullptr);
+	// one shared poll for all targets, the reported time is accurate to the poll interval
+	if (!waiting) {
+		streamFirstPacketTimer.stop();
+	} else if (!streamFirstPacketTimer.isActive()) {
+		streamFirstPacketTimer.start();
 	}
 }
 
 void CanvasDock::StopStream()
 {
 	streamButton->setChecked(false);
+	if (streamStartBatch) {
+		streamStartPending.clear();
+		streamStartTimer.stop();
+		CheckStreamStartBatch();
+	}
 	bool done = false;
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
-		if (obs_output_active(it->output)) {
+		const bool live = stream_output_live(*it);
+		it->reconnect_pending = false;
+		it->was_live = false;
+		it->reconnect_attempt = 0;
+		if (live || it->connecting) {
 			obs_output_stop(it->output);
 			done = true;
 		}
 	}
-	if (done) {
-		SendVendorEvent("streaming_stopping");
-	}
-	CheckReplayBuffer();
+	if (done) {
+		SendVendorEvent("streaming_stopping");
+	}
+	CheckReplayBuffer();
+}
+
+void CanvasDock::stream_output_start(void *data, calldata_t *calldata)
+{
+	auto d = static_cast<CanvasDock *>(data);
+	const uint64_t time = os_gettime_ns();
+	obs_output_t *output = (obs_output_t *)calldata_ptr(calldata, "output");
+	d->CheckReplayBuffer(true);
+	QMetaObject::invokeMethod(d, [d, output, time] { d->StreamOutputStarted(output, time); });
+	QMetaObject::invokeMethod(d, "OnStreamStart");
+}
+
+void CanvasDock::stream_output_stop(void *data, calldata_t *calldata)
+{
+	const char *last_error = (const char *)calldata_ptr(calldata, "last_error");
+	QString arg_last_error = QString::fromUtf8(last_error);
+	const int code = (int)calldata_int(calldata, "code");
+	auto d = static_cast<CanvasDock *>(data);
+	QString stream_server;
+	QString stream_key;
+	obs_output_t *t = (obs_output_t *)calldata_ptr(calldata, "output");
+	for (auto it = d->streamOutputs.begin(); it != d->streamOutputs.end(); ++it) {
+		if (it->output == t) {
+			stream_server = QString::fromUtf8(it->stream_server);
+			stream_key = QString::fromUtf8(it->stream_key);
+			it->stopping = true;
+		}
+	}
+
+	QMetaObject::invokeMethod(d, "OnStreamStop", Q_ARG(int, code), Q_ARG(QString, arg_last_error),
+				  Q_ARG(QString, stream_server), Q_ARG(QString, stream_key));
+}
+
+void CanvasDock::DestroyVideo()
+{
+	StopIdleDerivedVideo();
+	if (!canvas || !obs_canvas_has_video(canvas)) {
+		return;
+	}
+
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		if (it->output && obs_output_active(it->output)) {
+			return;
+		}
+	}
+
+	if (BacktrackActive() || obs_output_active(recordOutput) ||
+	    (obs_output_active(virtualCamOutput) && multiCanvasVideo == nullptr)) {
+		return;
+	}
+
+	for (auto &dc : derivedCanvases) {
+		if (obs_output_active(dc.recordOutput)) {
+			return;
+		}
+	}
+
+	if (replayOutput && obs_output_get_video_encoder(replayOutput)) {
+		obs_encoder_set_video(obs_output_get_video_encoder(replayOutput), nullptr);
+	}
+	if (diskReplayOutput && obs_output_get_video_encoder(diskReplayOutput)) {
+		obs_encoder_set_video(obs_output_get_video_encoder(diskReplayOutput), nullptr);
+	}
+	if (recordOutput && obs_output_get_video_encoder(recordOutput)) {
+		obs_encoder_set_video(obs_output_get_video_encoder(recordOutput), nullptr);
+	}
+	if (virtualCamOutput) {
+		obs_output_set_media(virtualCamOutput, nullptr, obs_get_audio());
+	}
+	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
+		if (it->output && obs_output_get_video_encoder(it->output)) {
+			obs_encoder_set_video(obs_output_get_video_encoder(it->output), nullptr);
+		}
+	}
+}
+
+void CanvasDock::LoadDerivedCanvases(obs_data_array_t *derived)
+{
+	const size_t count = obs_data_array_count(derived);
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *item = obs_data_array_item(derived, i);
+		if (!item) {
+			continue;
+		}
+		obs_data_set_default_bool(item, "record", true);
+		DerivedCanvas dc;
+		dc.name = obs_data_get_string(item, "name");
+		dc.width = (uint32_t)obs_data_get_int(item, "width");
+		dc.height = (uint32_t)obs_data_get_int(item, "height");
+		dc.record = obs_data_get_bool(item, "record");
+		obs_data_release(item);
+		if (!dc.width || !dc.height) {
+			continue;
+		}
+		if ((dc.width & 1) == 1) {
+			dc.width++;
+		}
+		if ((dc.height & 1) == 1) {
+			dc.height++;
+		}
+		if (dc.name.empty()) {
+			dc.name = std::to_string(dc.width) + "x" + std::to_string(dc.height);
+		}
+		derivedCanvases.push_back(dc);
+	}
+}
+
+obs_data_array_t *CanvasDock::SaveDerivedCanvases()
+{
+	obs_data_array_t *derived = obs_data_array_create();
+	for (const auto &dc : derivedCanvases) {
+		obs_data_t *item = obs_data_create();
+		obs_data_set_string(item, "name", dc.name.c_str());
+		obs_data_set_int(item, "width", dc.width);
+		obs_data_set_int(item, "height", dc.height);
+		obs_data_set_bool(item, "record", dc.record);
+		obs_data_array_push_back(derived, item);
+		obs_data_release(item);
+	}
+	return derived;
+}
+
+bool CanvasDock::StartDerivedVideo(DerivedCanvas &dc)
+{
+	if (!canvas) {
+		StartVideo();
+	}
+	if (!dc.source) {
+		obs_data_t *s = obs_data_create();
+		obs_data_set_int(s, "width", dc.width);
+		obs_data_set_int(s, "height", dc.height);
+		std::string source_name = "vertical_derived_canvas_" + dc.name;
+		dc.source = obs_source_create_private("vertical_derived_canvas_source", source_name.c_str(), s);
+		obs_data_release(s);
+	}
+	derived_canvas_source_set_parent(obs_obj_get_data(dc.source), canvas, canvas_width, canvas_height);
+
+	if (dc.canvas && obs_canvas_removed(dc.canvas)) {
+		obs_canvas_release(dc.canvas);
+		dc.canvas = nullptr;
+	}
+	if (!dc.canvas) {
+		std::string derived_name = canvas_name + " " + dc.name;
+		dc.canvas = obs_canvas_create(derived_name.c_str(), nullptr, DEVICE);
+		obs_canvas_set_channel(dc.canvas, 0, dc.source);
+	}
+
+	obs_video_info ovi;
+	if (obs_canvas_has_video(dc.canvas) && obs_canvas_get_video_info(dc.canvas, &ovi) && ovi.base_width == dc.width &&
+	    ovi.base_height == dc.height) {
+		return false;
+	}
+	obs_get_video_info(&ovi);
+	ovi.base_width = dc.width;
+	ovi.base_height = dc.height;
+	ovi.output_width = dc.width;
+	ovi.output_height = dc.height;
+	return obs_canvas_reset_video(dc.canvas, &ovi);
+}
+
+void CanvasDock::ReleaseDerivedCanvas(DerivedCanvas &dc)
+{
+	if (obs_output_active(dc.recordOutput)) {
+		obs_output_stop(dc.recordOutput);
+	}
+	if (dc.recordOutput) {
+		signal_handler_disconnect(obs_output_get_signal_handler(dc.recordOutput), "stop", derived_record_output_stop, this);
+	}
+	obs_output_release(dc.recordOutput);
+	dc.recordOutput = nullptr;
+	obs_encoder_release(dc.videoEncoder);
+	dc.videoEncoder = nullptr;
+	if (dc.canvas) {
+		obs_canvas_set_channel(dc.canvas, 0, nullptr);
+		obs_canvas_remove(dc.canvas);
+		obs_canvas_release(dc.canvas);
+		dc.canvas = nullptr;
+	}
+	obs_source_release(dc.source);
+	dc.source = nullptr;
+}
+
+// a derived canvas renders the whole vertical composite every frame, so its video only lives while a derived
+// recording or a get_derived_video consumer is connected to it
+void CanvasDock::StopIdleDerivedVideo()
+{
+	for (auto &dc : derivedCanvases) {
+		if (!dc.canvas || obs_output_active(dc.recordOutput)) {
+			continue;
+		}
+		video_t *video = obs_canvas_get_video(dc.canvas);
+		if (video && video_output_active(video)) {
+			continue;
+		}
+		if (dc.videoEncoder && !obs_encoder_active(dc.videoEncoder)) {
+			obs_encoder_set_video(dc.videoEncoder, nullptr);
+		}
+		obs_canvas_set_channel(dc.canvas, 0, nullptr);
+		obs_canvas_remove(dc.canvas);
+		obs_canvas_release(dc.canvas);
+		dc.canvas = nullptr;
+	}
 }
 
-void CanvasDock::stream_output_start(void *data, calldata_t *calldata)
+void CanvasDock::derived_record_output_stop(void *data, calldata_t *calldata)
 {
 	UNUSED_PARAMETER(calldata);
 	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("streaming_started");
-	d->CheckReplayBuffer(true);
-	QMetaObject::invokeMethod(d, "OnStreamStart");
+	QMetaObject::invokeMethod(d, [d] { d->StopIdleDerivedVideo(); }, Qt::QueuedConnection);
 }
 
-void CanvasDock::stream_output_stop(void *data, calldata_t *calldata)
+void CanvasDock::UpdateDerivedCanvases()
 {
-	const char *last_error = (const char *)calldata_ptr(calldata, "last_error");
-	QString arg_last_error = QString::fromUtf8(last_error);
-	const int code = (int)calldata_int(calldata, "code");
-	auto d = static_cast<CanvasDock *>(data);
-	d->SendVendorEvent("streaming_stopped");
-	QString stream_server;
-	QString stream_key;
-	obs_output_t *t = (obs_output_t *)calldata_ptr(calldata, "output");
-	for (auto it = d->streamOutputs.begin(); it != d->streamOutputs.end(); ++it) {
-		if (it->output == t) {
-			stream_server = QString::fromUtf8(it->stream_server);
-			stream_key = QString::fromUtf8(it->stream_key);
-			it->stopping = true;
+	for (auto &dc : derivedCanvases) {
+		if (dc.source) {
+			derived_canvas_source_set_parent(obs_obj_get_data(dc.source), canvas, canvas_width, canvas_height);
 		}
 	}
-
-	QMetaObject::invokeMethod(d, "OnStreamStop", Q_ARG(int, code), Q_ARG(QString, arg_last_error),
-				  Q_ARG(QString, stream_server), Q_ARG(QString, stream_key));
 }
 
-void CanvasDock::DestroyVideo()
+video_t *CanvasDock::GetDerivedVideo(uint32_t width, uint32_t height)
 {
-	if (!canvas || !obs_canvas_has_video(canvas)) {
-		return;
+	for (auto &dc : derivedCanvases) {
+		if ((width && dc.width != width) || (height && dc.height != height)) {
+			continue;
+		}
+		StartDerivedVideo(dc);
+		return obs_canvas_get_video(dc.canvas);
 	}
+	return nullptr;
+}
 
-	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
-		if (it->output && obs_output_active(it->output)) {
-			return;
-		}
+static std::string derived_record_path(const char *path, const std::string &suffix)
+{
+	std::string p = path ? path : "";
+	const auto slash = p.find_last_of("/\\");
+	const auto dot = p.find_last_of('.');
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+		return p + suffix;
 	}
+	return p.substr(0, dot) + suffix + p.substr(dot);
+}
 
-	if (obs_output_active(replayOutput) || obs_output_active(recordOutput) ||
-	    (obs_output_active(virtualCamOutput) && multiCanvasVideo == nullptr)) {
+void CanvasDock::StartDerivedRecord()
+{
+	obs_encoder_t *main_encoder = obs_output_get_video_encoder(recordOutput);
+	if (!main_encoder) {
 		return;
 	}
+	for (auto &dc : derivedCanvases) {
+		if (!dc.record || obs_output_active(dc.recordOutput)) {
+			continue;
+		}
+		StartDerivedVideo(dc);
 
-	if (replayOutput && obs_output_get_video_encoder(replayOutput)) {
-		obs_encoder_set_video(obs_output_get_video_encoder(replayOutput), nullptr);
-	}
-	if (recordOutput && obs_output_get_video_encoder(recordOutput)) {
-		obs_encoder_set_video(obs_output_get_video_encoder(recordOutput), nullptr);
-	}
-	if (virtualCamOutput) {
-		obs_output_set_media(virtualCamOutput, nullptr, obs_get_audio());
+		const char *enc_id = obs_encoder_get_id(main_encoder);
+		if (!dc.videoEncoder || strcmp(obs_encoder_get_id(dc.videoEncoder), enc_id) != 0) {
+			obs_encoder_release(dc.videoEncoder);
+			std::string encoder_name = "vertical_canvas_record_video_encoder_" + dc.name;
+			dc.videoEncoder = obs_video_encoder_create(enc_id, encoder_name.c_str(), nullptr, nullptr);
+		}
+		obs_data_t *es = obs_encoder_get_settings(main_encoder);
+		obs_encoder_update(dc.videoEncoder, es);
+		obs_data_release(es);
+		if (!obs_encoder_active(dc.videoEncoder)) {
+			obs_encoder_set_preferred_video_format(dc.videoEncoder,
+							       obs_encoder_get_preferred_video_format(main_encoder));
+			obs_encoder_set_video(dc.videoEncoder, obs_canvas_get_video(dc.canvas));
+		}
+
+		const char *output_id = obs_output_get_id(recordOutput);
+		if (!dc.recordOutput || strcmp(obs_output_get_id(dc.recordOutput), output_id) != 0) {
+			if (dc.recordOutput) {
+				signal_handler_disconnect(obs_output_get_signal_handler(dc.recordOutput), "stop",
+							  derived_record_output_stop, this);
+			}
+			obs_output_release(dc.recordOutput);
+			std::string output_name = "vertical_canvas_record_" + dc.name;
+			dc.recordOutput = obs_output_create(output_id, output_name.c_str(), nullptr, nullptr);
+			signal_handler_connect(obs_output_get_signal_handler(dc.recordOutput), "stop", derived_record_output_stop, this);
+		}
+		obs_output_set_video_encoder(dc.recordOutput, dc.videoEncoder);
+		for (size_t i = 0; i < MAX_AUDIO_MIXES; i++) {
+			obs_encoder_t *aet = obs_output_get_audio_encoder(recordOutput, i);
+			if (!aet) {
+				break;
+			}
+			obs_output_set_audio_encoder(dc.recordOutput, aet, i);
+		}
+
+		const std::string suffix = "-" + dc.name;
+		obs_data_t *ms = obs_output_get_settings(recordOutput);
+		obs_data_t *ps = obs_data_create();
+		obs_data_apply(ps, ms);
+		obs_data_set_string(ps, "path", derived_record_path(obs_data_get_string(ms, "path"), suffix).c_str());
+		if (obs_data_has_user_value(ms, "url")) {
+			obs_data_set_string(ps, "url", derived_record_path(obs_data_get_string(ms, "url"), suffix).c_str());
+		}
+		std::string format = obs_data_get_string(ms, "format");
+		format += suffix;
+		obs_data_set_string(ps, "format", format.c_str());
+		obs_output_update(dc.recordOutput, ps);
+		obs_data_release(ps);
+		obs_data_release(ms);
+
+		if (!obs_output_start(dc.recordOutput)) {
+			blog(LOG_WARNING, "[Vertical Canvas] failed to start derived recording %s", dc.name.c_str());
+			StopIdleDerivedVideo();
+		}
 	}
-	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
-		if (it->output && obs_output_get_video_encoder(it->output)) {
-			obs_encoder_set_video(obs_output_get_video_encoder(it->output), nullptr);
+}
+
+void CanvasDock::StopDerivedRecord()
+{
+	for (auto &dc : derivedCanvases) {
+		if (obs_output_active(dc.recordOutput)) {
+			obs_output_stop(dc.recordOutput);
 		}
 	}
 }
@@ -6860,14 +8903,10 @@ obs_scene_t *CanvasDock::GetCurrentScene()
 std::vector<QString> CanvasDock::GetScenes()
 {
 	std::vector<QString> scenes;
-	if (scenesDock) {
-		for (int i = 0; i < scenesDock->sceneList->count(); i++) {
-			scenes.push_back(scenesDock->sceneList->item(i)->text());
-		}
-	} else if (scenesCombo) {
-		for (int i = 0; i < scenesCombo->count(); i++) {
-			scenes.push_back(scenesCombo->itemText(i));
-		}
+	const int count = sceneModel->rowCount();
+	scenes.reserve(count);
+	for (int i = 0; i < count; i++) {
+		scenes.push_back(sceneModel->Name(i));
 	}
 	return scenes;
 }
@@ -6875,21 +8914,35 @@ std::vector<QString> CanvasDock::GetScenes()
 bool CanvasDock::StreamingActive()
 {
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
-		if (obs_output_active(it->output)) {
+		if (stream_output_live(*it)) {
 			return true;
 		}
 	}
 	return false;
 }
 
+obs_data_array_t *CanvasDock::GetStreamStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	auto outputs = stats ? obs_data_get_array(stats, "stream_outputs") : nullptr;
+	return outputs ? outputs : obs_data_array_create();
+}
+
 bool CanvasDock::RecordingActive()
 {
 	return obs_output_active(recordOutput);
 }
 
+obs_data_t *CanvasDock::GetRecordStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	auto record = stats ? obs_data_get_obj(stats, "record") : nullptr;
+	return record ? record : obs_data_create();
+}
+
 bool CanvasDock::BacktrackActive()
 {
-	return obs_output_active(replayOutput);
+	return obs_output_active(replayOutput) || obs_output_active(diskReplayOutput);
 }
 
 bool CanvasDock::VirtualCameraActive()
@@ -6907,22 +8960,32 @@ obs_data_t *CanvasDock::SaveSettings()
 	if (scenesDock) {
 		obs_data_set_bool(save_data, "grid_mode", scenesDock->IsGridMode());
 	}
+	if (sourcesDock) {
+		obs_data_set_bool(save_data, "virtual_source_list", sourcesDock->sourceList->IsVirtualized());
+	}
 
+	obs_data_set_string(save_data, "dock_id", dock_id.c_str());
+	obs_data_set_string(save_data, "canvas_name", canvas_name.c_str());
+	obs_data_set_string(save_data, "canvas_uuid", canvas_uuid.c_str());
+	obs_data_set_string(save_data, "title", dock_title.c_str());
 	obs_data_set_int(save_data, "width", canvas_width);
 	obs_data_set_int(save_data, "height", canvas_height);
 	obs_data_set_int(save_data, "partner_block", partnerBlockTime);
 	obs_data_set_bool(save_data, "preview_disabled", preview_disabled);
+	obs_data_set_bool(save_data, "show_stats", show_stats);
 	obs_data_set_bool(save_data, "virtual_cam_warned", virtual_cam_warned);
 	obs_data_set_int(save_data, "streaming_video_bitrate", streamingVideoBitrate);
 	obs_data_set_bool(save_data, "streaming_match_main", streamingMatchMain);
 	obs_data_set_int(save_data, "record_video_bitrate", recordVideoBitrate);
 	obs_data_set_int(save_data, "max_size_mb", max_size_mb);
 	obs_data_set_int(save_data, "max_time_sec", max_time_sec);
+	obs_data_set_int(save_data, "record_write_buffer_mb", record_write_buffer_mb);
 	obs_data_set_bool(save_data, "recording_match_main", recordingMatchMain);
 	obs_data_set_int(save_data, "audio_bitrate", audioBitrate);
 	obs_data_set_bool(save_data, "backtrack", startReplay);
 	obs_data_set_int(save_data, "backtrack_seconds", replayDuration);
 	obs_data_set_string(save_data, "backtrack_path", replayPath.c_str());
+	obs_data_set_bool(save_data, "backtrack_disk", replayDisk);
 	if (replayOutput) {
 		auto hotkeys = obs_hotkeys_save_output(replayOutput);
 		obs_data_set_obj(save_data, "backtrack_hotkeys", hotkeys);
@@ -6935,9 +8998,16 @@ obs_data_t *CanvasDock::SaveSettings()
 	obs_data_set_array(save_data, "stream_outputs", stream_servers);
 	obs_data_array_release(stream_servers);
 
+	obs_data_array_t *derived = SaveDerivedCanvases();
+	obs_data_set_array(save_data, "derived_canvases", derived);
+	obs_data_array_release(derived);
+
 	obs_data_set_bool(save_data, "stream_delay_enabled", stream_delay_enabled);
 	obs_data_set_int(save_data, "stream_delay_duration", stream_delay_duration);
 	obs_data_set_bool(save_data, "stream_delay_preserve", stream_delay_preserve);
+	obs_data_set_int(save_data, "stream_start_parallel", stream_start_parallel);
+	obs_data_set_int(save_data, "stream_start_stagger_ms", stream_start_stagger_ms);
+	obs_data_set_int(save_data, "scene_prewarm_ttl_ms", scene_prewarm_ttl_ms);
 
 	obs_data_set_bool(save_data, "stream_advanced_settings", stream_advanced_settings);
 	obs_data_set_int(save_data, "stream_audio_track", stream_audio_track);
@@ -7000,6 +9070,9 @@ obs_data_t *CanvasDock::SaveSettings()
 	start_hotkey = obs_hotkey_save(split_hotkey);
 	obs_data_set_array(save_data, "split_hotkey", start_hotkey);
 	obs_data_array_release(start_hotkey);
+	start_hotkey = obs_hotkey_save(save_disk_backtrack_hotkey);
+	obs_data_set_array(save_data, "save_disk_backtrack_hotkey", start_hotkey);
+	obs_data_array_release(start_hotkey);
 
 	obs_data_array_t *transition_array = obs_data_array_create();
 	for (auto transition : transitions) {
@@ -7025,11 +9098,10 @@ obs_data_t *CanvasDock::SaveSettings()
 void CanvasDock::ClearScenes()
 {
 	clearing = true;
-	if (scenesCombo) {
-		scenesCombo->clear();
-	}
-	if (scenesDock && scenesDock->sceneList->count()) {
-		scenesDock->sceneList->clear();
+	ExpirePrewarmedScenes(true);
+	linkedScenes.clear();
+	if (sceneModel->rowCount()) {
+		sceneModel->Clear();
 	}
 	SwitchScene("", false);
 	if (canvas) {
@@ -7061,13 +9133,7 @@ void CanvasDock::LoadScenes()
 		}
 		obs_source_release(s);
 	}
-	if (scenesCombo) {
-		scenesCombo->clear();
-	}
-
-	if (scenesDock) {
-		scenesDock->sceneList->clear();
-	}
+	sceneModel->Clear();
 
 	StartVideo();
 
@@ -7075,76 +9141,15 @@ void CanvasDock::LoadScenes()
 		canvas,
 		[](void *param, obs_source_t *src) {
 			auto t = (CanvasDock *)param;
-			struct find_hotkey {
-				obs_source_t *source;
-				bool found = false;
-			};
-			find_hotkey f = {src, false};
-
-			obs_enum_hotkeys(
-				[](void *param, obs_hotkey_id id, obs_hotkey_t *key) {
-					UNUSED_PARAMETER(id);
-					auto f = (find_hotkey *)param;
-					if (obs_hotkey_get_registerer_type(key) != OBS_HOTKEY_REGISTERER_SOURCE) {
-						return true;
-					}
-					auto potential_source = (obs_weak_source_t *)obs_hotkey_get_registerer(key);
-					if (obs_hotkey_get_registerer(key) != f->source &&
-					    !obs_weak_source_references_source(potential_source, f->source)) {
-						return true;
-					}
-					if (strcmp("OBSBasic.SelectScene", obs_hotkey_get_name(key)) != 0) {
-						return true;
-					}
-					f->found = true;
-					return false;
-				},
-				&f);
-			if (!f.found) {
-				std::string ssn = obs_canvas_get_name(t->canvas);
-				ssn += " ";
-				ssn += obs_frontend_get_locale_string("Basic.Hotkeys.SelectScene");
-				obs_hotkey_register_source(
-					src, "OBSBasic.SelectScene", ssn.c_str(),
-					[](void *data, obs_hotkey_id, obs_hotkey_t *key, bool pressed) {
-						if (!pressed) {
-							return;
-						}
-						auto p = (CanvasDock *)data;
-						auto potential_source = (obs_weak_source_t *)obs_hotkey_get_registerer(key);
-						OBSSourceAutoRelease source = obs_weak_source_get_source(potential_source);
-						if (source) {
-							auto sn = QString::fromUtf8(obs_source_get_name(source));
-							QMetaObject::invokeMethod(p, "SwitchScene", Q_ARG(QString, sn),
-										  Q_ARG(bool, true));
-						}
-					},
-					t);
-			}
+			t->RegisterSceneHotkeys(src);
 			auto sh = obs_source_get_signal_handler(src);
 			signal_handler_connect(sh, "rename", source_rename, t);
 			QString name = QString::fromUtf8(obs_source_get_name(src));
-			if (t->scenesCombo) {
-				t->scenesCombo->addItem(name);
-			}
-			if (t->scenesDock) {
-				t->scenesDock->sceneList->addItem(name);
-			}
+			t->sceneModel->Add(src);
 			obs_data_t *settings = obs_source_get_settings(src);
 			if ((t->currentSceneName.isEmpty() && obs_data_get_bool(settings, "canvas_active")) ||
 			    name == t->currentSceneName) {
-				if (t->scenesCombo) {
-					t->scenesCombo->setCurrentText(name);
-				}
-				if (t->scenesDock) {
-					for (int j = 0; j < t->scenesDock->sceneList->count(); j++) {
-						auto item = t->scenesDock->sceneList->item(j);
-						if (item->text() != name) {
-							continue;
-						}
-						t->scenesDock->sceneList->setCurrentItem(item);
-					}
-				}
+				t->SetCurrentSceneRow(t->sceneModel->Row(name));
 			}
 			obs_data_release(settings);
 			return true;
@@ -7186,59 +9191,33 @@ void CanvasDock::LoadScenes()
 			}
 			QString name = QString::fromUtf8(obs_source_get_name(src));
 			const int order = (int)obs_data_get_int(settings, "order");
-			if (scenesCombo) {
-				scenesCombo->insertItem(order, name);
-			}
-			if (scenesDock) {
-				scenesDock->sceneList->insertItem(order, name);
-			}
+			sceneModel->Add(src, order);
 
 			if ((currentSceneName.isEmpty() && obs_data_get_bool(settings, "canvas_active")) ||
 			    name == currentSceneName) {
-				if (scenesCombo) {
-					scenesCombo->setCurrentText(name);
-				}
-				if (scenesDock) {
-					for (int j = 0; j < scenesDock->sceneList->count(); j++) {
-						auto item = scenesDock->sceneList->item(j);
-						if (item->text() != name) {
-							continue;
-						}
-						scenesDock->sceneList->setCurrentItem(item);
-					}
-				}
+				SetCurrentSceneRow(sceneModel->Row(name));
 			}
 		}
 		obs_data_release(settings);
 	}
 	obs_frontend_source_list_free(&scenes);
-	if (scenesDock && scenesDock->sceneList->count() > 0) {
-		QListWidgetItem *selectedItem = nullptr;
-		scenesDock->sceneList->blockSignals(true);
-		for (int idx = 0; idx < scenesDock->sceneList->count(); idx++) {
-			auto item = scenesDock->sceneList->takeItem(idx);
-			auto scene = obs_canvas_get_source_by_name(canvas, item->text().toUtf8().constData());
-			auto settings = obs_source_get_settings(scene);
-			const int order = (int)obs_data_get_int(settings, "order");
-			scenesDock->sceneList->insertItem(order, item);
-			if (obs_data_get_bool(settings, "canvas_active")) {
-				selectedItem = item;
-			}
-			obs_data_release(settings);
-			obs_source_release(scene);
-		}
-		scenesDock->sceneList->blockSignals(false);
-		if (selectedItem) {
-			scenesDock->sceneList->setCurrentItem(selectedItem);
+	if (scenesDock && sceneModel->rowCount() > 0) {
+		auto selection = scenesDock->sceneList->selectionModel();
+		selection->blockSignals(true);
+		const int selectedRow = sceneModel->SortBySavedOrder();
+		selection->blockSignals(false);
+		if (selectedRow >= 0) {
+			scenesDock->SetCurrentRow(selectedRow);
 		}
 	}
-	if ((scenesDock && scenesDock->sceneList->count() == 0) || (scenesCombo && scenesCombo->count() == 0)) {
+	if (sceneModel->rowCount() == 0) {
 		AddScene("", false);
 	}
 
-	if (scenesDock && scenesDock->sceneList->currentRow() < 0) {
-		scenesDock->sceneList->setCurrentRow(0);
+	if (scenesDock && scenesDock->CurrentRow() < 0) {
+		scenesDock->SetCurrentRow(0);
 	}
+	RebuildLinkedScenes();
 }
 
 void CanvasDock::SwitchScene(const QString &scene_name, bool transition)
@@ -7327,21 +9306,8 @@ void CanvasDock::SwitchScene(const QString &scene_name, bool transition)
 	if (!scene_name.isEmpty()) {
 		currentSceneName = scene_name;
 	}
-	if (scenesCombo && scenesCombo->currentText() != scene_name) {
-		scenesCombo->setCurrentText(scene_name);
-	}
-	if (scenesDock && !scene_name.isEmpty()) {
-		QListWidgetItem *item = scenesDock->sceneList->currentItem();
-		if (!item || item->text() != scene_name) {
-			for (int i = 0; i < scenesDock->sceneList->count(); i++) {
-				item = scenesDock->sceneList->item(i);
-				if (item->text() == scene_name) {
-					scenesDock->sceneList->setCurrentRow(i);
-					item->setSelected(true);
-					break;
-				}
-			}
-		}
+	if (!scene_name.isEmpty()) {
+		SetCurrentSceneRow(sceneModel->Row(scene_name));
 	}
 	if (sourcesDock) {
 		sourcesDock->sourceList->GetStm()->SceneChanged();
@@ -7457,28 +9423,8 @@ void CanvasDock::source_rename(void *data, calldata_t *calldata)
 	}
 	obs_frontend_source_list_free(&scenes);
 
-	if (d->scenesDock) {
-		for (int i = 0; i < d->scenesDock->sceneList->count(); i++) {
-			const auto item = d->scenesDock->sceneList->item(i);
-			if (item->text() != prev_name) {
-				continue;
-			}
-			item->setText(new_name);
-		}
-	}
-	if (d->scenesCombo) {
-
-		for (int i = 0; i < d->scenesCombo->count(); i++) {
-			if (d->scenesCombo->itemText(i) != prev_name) {
-				continue;
-			}
-			const bool selected = d->scenesCombo->currentText() == prev_name;
-			d->scenesCombo->removeItem(i);
-			d->scenesCombo->addItem(new_name);
-			if (selected) {
-				d->scenesCombo->setCurrentText(new_name);
-			}
-		}
+	if (d->sceneModel) {
+		d->sceneModel->Rename(source, prev_name, new_name);
 	}
 }
 
@@ -7492,6 +9438,20 @@ void CanvasDock::source_remove(void *data, calldata_t *calldata)
 	const auto canvas = obs_source_get_canvas(source);
 	obs_canvas_release(canvas);
 	if (!canvas || canvas != d->canvas) {
+		const char *uuid = obs_source_get_uuid(source);
+		if (uuid) {
+			// a collection switch can rebuild the map before this runs, only drop the entry of this very source
+			OBSWeakSource weak = OBSGetWeakRef(source);
+			QMetaObject::invokeMethod(
+				d,
+				[d, id = std::string(uuid), weak] {
+					auto it = d->linkedScenes.find(id);
+					if (it != d->linkedScenes.end() && it->second.main.Get() == weak.Get()) {
+						d->linkedScenes.erase(it);
+					}
+				},
+				Qt::QueuedConnection);
+		}
 		return;
 	}
 	if (obs_weak_source_references_source(d->source, source) || source == obs_scene_get_source(d->scene)) {
@@ -7504,32 +9464,52 @@ void CanvasDock::source_remove(void *data, calldata_t *calldata)
 	QMetaObject::invokeMethod(d, "SceneRemoved", Q_ARG(QString, name));
 }
 
+// duplicated main scenes carry the canvas link in their settings
+void CanvasDock::source_create(void *data, calldata_t *calldata)
+{
+	const auto d = static_cast<CanvasDock *>(data);
+	const auto source = (obs_source_t *)calldata_ptr(calldata, "source");
+	if (!source || !obs_source_is_scene(source)) {
+		return;
+	}
+	OBSWeakSource weak = OBSGetWeakRef(source);
+	QMetaObject::invokeMethod(
+		d,
+		[d, weak] {
+			OBSSource main_scene = OBSGetStrongRef(weak);
+			if (!main_scene || d->clearing || d->switching) {
+				return;
+			}
+			std::string linked_name;
+			if (d->GetLinkedSceneName(main_scene, linked_name)) {
+				d->UpdateLinkedScene(main_scene, linked_name.c_str());
+			}
+		},
+		Qt::QueuedConnection);
+}
+
 void CanvasDock::SceneRemoved(const QString name)
 {
 	if (clearing || switching) {
 		return;
 	}
-	if (scenesDock) {
-		for (int i = 0; i < scenesDock->sceneList->count(); i++) {
-			auto item = scenesDock->sceneList->item(i);
-			if (item->text() != name) {
-				continue;
-			}
-			scenesDock->sceneList->takeItem(i);
+	sceneModel->Remove(name);
+	for (auto it = linkedScenes.begin(); it != linkedScenes.end();) {
+		OBSSource linked = OBSGetStrongRef(it->second.linked);
+		if (!linked || obs_source_removed(linked)) {
+			it = linkedScenes.erase(it);
+		} else {
+			++it;
 		}
-		auto r = scenesDock->sceneList->currentRow();
-		auto c = scenesDock->sceneList->count();
+	}
+	if (scenesDock) {
+		auto r = scenesDock->CurrentRow();
+		auto c = sceneModel->rowCount();
 		if (!clearing && !switching && ((r < 0 && c > 0) || r >= c)) {
-			scenesDock->sceneList->setCurrentRow(0);
+			scenesDock->SetCurrentRow(0);
 		}
 	}
 	if (scenesCombo) {
-		for (int i = 0; i < scenesCombo->count(); i++) {
-			if (scenesCombo->itemText(i) != name) {
-				continue;
-			}
-			scenesCombo->removeItem(i);
-		}
 		if (!clearing && !switching && scenesCombo->currentIndex() < 0 && scenesCombo->count()) {
 			scenesCombo->setCurrentIndex(0);
 		}
@@ -7648,6 +9628,11 @@ void CanvasDock::OnRecordStart()
 
 void CanvasDock::TryRemux(QString path)
 {
+#ifdef ENABLE_REMUX_QUEUE
+	if (config_get_bool(obs_frontend_get_profile_config(), "Video", "AutoRemux")) {
+		remux_queue_add(path.toUtf8().constData(), remux_progress, remux_finished, this);
+	}
+#else
 	const obs_encoder_t *videoEncoder = nullptr;
 	obs_output_t *ro = obs_frontend_get_recording_output();
 	if (ro) {
@@ -7681,6 +9666,38 @@ void CanvasDock::TryRemux(QString path)
 		const auto main_window = static_cast<QMainWindow *>(obs_frontend_get_main_window());
 		QMetaObject::invokeMethod(main_window, "RecordingFileChanged", Q_ARG(QString, path));
 	}
+#endif
+}
+
+void CanvasDock::remux_progress(void *param, const char *path, int percent)
+{
+	UNUSED_PARAMETER(path);
+	auto d = static_cast<CanvasDock *>(param);
+	QMetaObject::invokeMethod(d, "OnRemuxProgress", Q_ARG(int, percent));
+}
+
+void CanvasDock::remux_finished(void *param, const char *path, const char *output, bool success)
+{
+	auto d = static_cast<CanvasDock *>(param);
+	const auto data = obs_data_create();
+	obs_data_set_string(data, "path", path);
+	obs_data_set_string(data, "output", output);
+	obs_data_set_bool(data, "success", success);
+	d->SendVendorEvent("remux_completed", data);
+	obs_data_release(data);
+	QMetaObject::invokeMethod(d, "OnRemuxFinished", Q_ARG(bool, success));
+}
+
+void CanvasDock::OnRemuxProgress(int percent)
+{
+	statusLabel->setText(QString::fromUtf8(obs_module_text("Remuxing")).arg(percent));
+	replayStatusResetTimer.start(10000);
+}
+
+void CanvasDock::OnRemuxFinished(bool success)
+{
+	statusLabel->setText(QString::fromUtf8(obs_module_text(success ? "Remuxed" : "RemuxFailed")));
+	replayStatusResetTimer.start(4000);
 }
 
 void CanvasDock::OnRecordStop(int code, QString last_error)
@@ -7690,6 +9707,7 @@ void CanvasDock::OnRecordStop(int code, QString last_error)
 	recordButton->setText("");
 	recordButton->setChecked(false);
 	HandleRecordError(code, last_error);
+	StopDerivedRecord();
 	CheckReplayBuffer();
 	QTimer::singleShot(500, this, [this] { CheckReplayBuffer(); });
 	obs_data_t *s = obs_output_get_settings(recordOutput);
@@ -7736,7 +9754,6 @@ void CanvasDock::HandleRecordError(int code, QString last_error)
 void CanvasDock::OnReplaySaved()
 {
 	std::string path;
-	statusLabel->setText(QString::fromUtf8(obs_module_text("Saved")));
 	if (replayOutput) {
 		proc_handler_t *ph = obs_output_get_proc_handler(replayOutput);
 		if (ph) {
@@ -7750,8 +9767,21 @@ void CanvasDock::OnReplaySaved()
 			calldata_free(&cd);
 		}
 	}
-	if (!path.empty()) {
-		TryRemux(QString::fromUtf8(path.c_str()));
+	replaySaveTimeoutTimer.stop();
+	if (replaySaving) {
+		const uint64_t duration = os_gettime_ns() - replaySaveStart;
+		const int64_t size = path.empty() ? 0 : os_get_file_size(path.c_str());
+		SendBacktrackSaveCompleted(path.c_str(), size > 0 ? (uint64_t)size : 0, duration, replaySaveSeconds);
+	}
+	OnBacktrackFileSaved(QString::fromUtf8(path.c_str()));
+	StartNextReplaySave();
+}
+
+void CanvasDock::OnBacktrackFileSaved(QString path)
+{
+	statusLabel->setText(QString::fromUtf8(obs_module_text("Saved")));
+	if (!path.isEmpty()) {
+		TryRemux(path);
 	}
 	replayStatusResetTimer.start(4000);
 }
@@ -7763,6 +9793,7 @@ void CanvasDock::OnStreamStart()
 	streamButton->setText("00:00");
 	streamButton->setChecked(true);
 	CheckReplayBuffer(true);
+	CheckStreamFirstPacket();
 }
 
 #ifndef OBS_OUTPUT_HDR_DISABLED
@@ -7772,13 +9803,32 @@ void CanvasDock::OnStreamStart()
 void CanvasDock::OnStreamStop(int code, QString last_error, QString stream_server, QString stream_key)
 {
 	bool active = false;
+	bool starting = false;
+	bool reconnecting = false;
+	QString name;
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
 		if (stream_server == QString::fromUtf8(it->stream_server) && stream_key == QString::fromUtf8(it->stream_key)) {
-		} else if (obs_output_active(it->output)) {
+			name = QString::fromUtf8(it->name.empty() ? it->stream_server : it->name);
+			if (it->connecting) {
+				it->connecting = false;
+				streamStartConnecting--;
+				starting = true;
+			}
+			if (code == OBS_OUTPUT_SUCCESS) {
+				it->was_live = false;
+				it->reconnect_attempt = 0;
+			} else if (!starting && it->was_live &&
+				   (code == OBS_OUTPUT_DISCONNECTED || code == OBS_OUTPUT_CONNECT_FAILED || code == OBS_OUTPUT_ERROR)) {
+				reconnecting = ScheduleStreamReconnect(it);
+			}
+			if (reconnecting) {
+				active = true;
+			}
+		} else if (obs_output_active(it->output) || it->reconnect_pending) {
 			active = true;
 		}
 	}
-	if (!active) {
+	if (!active && !streamStartBatch) {
 		streamButton->setChecked(false);
 		streamButton->setIcon(streamInactiveIcon);
 		streamButton->setText("");
@@ -7837,7 +9887,19 @@ void CanvasDock::OnStreamStop(int code, QString last_error, QString stream_serve
 			blog(LOG_WARNING, "[Vertical Canvas] stream stop error %i", code);
 		}
 	}
-	if (encode_error) {
+	if (reconnecting) {
+		// the canvas video, replay buffer and streaming state stay up until the reconnect succeeds or gives up
+		blog(LOG_INFO, "[Vertical Canvas] Stream output '%s' will reconnect", name.toUtf8().constData());
+		return;
+	}
+	SendVendorEvent("streaming_stopped");
+	if (starting && streamStartBatch) {
+		if (code != OBS_OUTPUT_SUCCESS) {
+			streamStartFailures.append(name + QString::fromUtf8(": ") + QString::fromUtf8(errorDescription) +
+						   (!last_error.isEmpty() ? QString::fromUtf8("\n") + last_error : QString()));
+		}
+		StartNextStreamOutputs();
+	} else if (encode_error) {
 		QString msg = last_error.isEmpty()
 				      ? QString::fromUtf8(obs_frontend_get_locale_string("Output.StreamEncodeError.Msg"))
 				      : QString::fromUtf8(obs_frontend_get_locale_string("Output.StreamEncodeError.Msg.LastError"))
@@ -7868,6 +9930,15 @@ void CanvasDock::OnReplayBufferStop(int code, QString last_error)
 	if (!replayStatusResetTimer.isActive()) {
 		replayStatusResetTimer.start(4000);
 	}
+	if (!obs_output_active(replayOutput)) {
+		replaySaveTimeoutTimer.stop();
+		replaySaving = false;
+		replaySaveQueue.clear();
+	}
+	if (diskReplayRing && !obs_output_active(diskReplayOutput)) {
+		backtrack_ring_destroy(diskReplayRing);
+		diskReplayRing = nullptr;
+	}
 	if (restart_video) {
 		ProfileChanged();
 	}
@@ -7880,48 +9951,18 @@ void CanvasDock::OnReplayBufferStop(int code, QString last_error)
 
 void CanvasDock::MainSceneChanged()
 {
+	// only reflect the link here, a toggle from the checkbox signal would write the link back to the scene settings
+	const bool blocked = linkedButton ? linkedButton->blockSignals(true) : false;
 	auto current_scene = obs_frontend_get_current_scene();
-	if (!current_scene) {
-		if (linkedButton) {
-			linkedButton->setChecked(false);
-		}
-		return;
-	}
-
-	auto ss = obs_source_get_settings(current_scene);
+	OBSSource linked = current_scene ? GetLinkedScene(current_scene) : OBSSource();
 	obs_source_release(current_scene);
-	auto c = obs_data_get_array(ss, "canvas");
-	obs_data_release(ss);
-	if (!c) {
-		if (linkedButton) {
-			linkedButton->setChecked(false);
-		}
-		return;
-	}
-	const auto count = obs_data_array_count(c);
-	obs_data_t *found = nullptr;
-	for (size_t i = 0; i < count; i++) {
-		auto item = obs_data_array_item(c, i);
-		if (!item) {
-			continue;
-		}
-		if (obs_data_get_int(item, "width") == canvas_width && obs_data_get_int(item, "height") == canvas_height) {
-			found = item;
-			break;
-		}
-		obs_data_release(item);
+	if (linked) {
+		SwitchScene(QString::fromUtf8(obs_source_get_name(linked)));
 	}
-	if (found) {
-		auto sn = QString::fromUtf8(obs_data_get_string(found, "scene"));
-		SwitchScene(sn);
-		if (linkedButton) {
-			linkedButton->setChecked(true);
-		}
-	} else if (linkedButton) {
-		linkedButton->setChecked(false);
+	if (linkedButton) {
+		linkedButton->setChecked(!!linked);
+		linkedButton->blockSignals(blocked);
 	}
-	obs_data_release(found);
-	obs_data_array_release(c);
 }
 
 bool CanvasDock::start_virtual_cam_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed)
@@ -8125,6 +10166,20 @@ void CanvasDock::recording_split_hotkey(void *data, obs_hotkey_id id, obs_hotkey
 	calldata_free(&cd);
 }
 
+void CanvasDock::save_disk_backtrack_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+	UNUSED_PARAMETER(id);
+	UNUSED_PARAMETER(hotkey);
+	if (!pressed) {
+		return;
+	}
+	const auto d = static_cast<CanvasDock *>(data);
+	if (!obs_output_active(d->diskReplayOutput)) {
+		return;
+	}
+	QMetaObject::invokeMethod(d, "ReplayButtonClicked", Q_ARG(QString, QString()));
+}
+
 QIcon CanvasDock::GetIconFromType(enum obs_icon_type icon_type) const
 {
 	const auto main_window = static_cast<QMainWindow *>(obs_frontend_get_main_window());
@@ -8284,12 +10339,18 @@ void CanvasDock::AddSceneItem(OBSSceneItem item)
 	obs_scene_enum_items(add_scene, select_one, (obs_sceneitem_t *)item);
 }
 
-void CanvasDock::SendVendorEvent(const char *event_name)
+void CanvasDock::SendVendorEvent(const char *event_name, obs_data_t *extra)
 {
 	if (!vendor) {
 		return;
 	}
 	const auto d = obs_data_create();
+	if (extra) {
+		obs_data_apply(d, extra);
+	}
+	const char *uuid = GetCanvasUuid();
+	obs_data_set_string(d, "canvas_uuid", uuid ? uuid : "");
+	obs_data_set_string(d, "canvas_name", canvas_name.c_str());
 	obs_data_set_int(d, "width", canvas_width);
 	obs_data_set_int(d, "height", canvas_height);
 	obs_websocket_vendor_emit_event(vendor, event_name, d);
@@ -8354,7 +10415,7 @@ void CanvasDock::Nudge(int dist, MoveDir dir)
 		break;
 	}
 
-	obs_scene_enum_items(scene, nudge_callback, &offset);
+	UpdateSelectedItems(scene, nudge_callback, &offset, true);
 }
 
 void RemoveWidget(QWidget *widget);
@@ -8472,6 +10533,7 @@ void CanvasDock::ApiInfo(QString info)
 
 void CanvasDock::ProfileChanged()
 {
+	DisarmStream();
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); ++it) {
 		if (obs_output_active(it->output)) {
 			return;
@@ -8488,6 +10550,12 @@ void CanvasDock::ProfileChanged()
 		return;
 	}
 
+	if (obs_output_active(diskReplayOutput)) {
+		obs_output_stop(diskReplayOutput);
+		restart_video = true;
+		return;
+	}
+
 	bool virtual_cam_active = obs_output_active(virtualCamOutput);
 	if (virtual_cam_active) {
 		StopVirtualCam();
@@ -8517,7 +10585,7 @@ void CanvasDock::DeleteProjector(OBSProjector *projector)
 	}
 }
 
-OBSProjector *CanvasDock::OpenProjector(int monitor)
+OBSProjector *CanvasDock::OpenProjector(int monitor, ProjectorType type)
 {
 	/* seriously?  10 monitors? */
 	if (monitor > 9 || monitor > QGuiApplication::screens().size() - 1) {
@@ -8539,13 +10607,20 @@ OBSProjector *CanvasDock::OpenProjector(int monitor)
 		}
 	}
 
-	OBSProjector *projector = new OBSProjector(this, monitor);
+	OBSProjector *projector = new OBSProjector(this, monitor, type);
 
 	projectors.emplace_back(projector);
 
 	return projector;
 }
 
+void CanvasDock::UpdateMultiviews()
+{
+	for (auto projector : projectors) {
+		projector->UpdateMultiview();
+	}
+}
+
 QString GetMonitorName(const QString &id);
 
 void CanvasDock::AddProjectorMenuMonitors(QMenu *parent, QObject *target, const char *slot)
@@ -8594,6 +10669,12 @@ void CanvasDock::OpenPreviewProjector()
 	OpenProjector(monitor);
 }
 
+void CanvasDock::OpenMultiviewProjector()
+{
+	int monitor = sender()->property("monitor").toInt();
+	OpenProjector(monitor, ProjectorType::Multiview);
+}
+
 void CanvasDock::OpenSourceProjector()
 {
 	int monitor = sender()->property("monitor").toInt();
@@ -8615,6 +10696,7 @@ void CanvasDock::updateStreamKey(const QString &newStreamKey, int index)
 		return;
 	}
 	streamOutputs[index].stream_key = newStreamKey.toStdString();
+	DisarmStream();
 }
 
 void CanvasDock::updateStreamServer(const QString &newStreamServer, int index)
@@ -8623,6 +10705,7 @@ void CanvasDock::updateStreamServer(const QString &newStreamServer, int index)
 		return;
 	}
 	streamOutputs[index].stream_server = newStreamServer.toStdString();
+	DisarmStream();
 }
 
 QMenu *CanvasDock::CreateVisibilityTransitionMenu(bool visible, obs_sceneitem_t *si)
@@ -8718,6 +10801,21 @@ void CanvasDock::get_transitions(void *data, struct obs_frontend_source_list *so
 	}
 }
 
+static void load_stream_server_policy(StreamServer &ss, obs_data_t *item)
+{
+	obs_data_set_default_int(item, "reconnect_retries", 10);
+	obs_data_set_default_int(item, "reconnect_delay_sec", 2);
+	obs_data_set_default_int(item, "reconnect_max_delay_sec", 60);
+	obs_data_set_default_double(item, "health", 100.0);
+	ss.reconnect_retries = (int)obs_data_get_int(item, "reconnect_retries");
+	ss.reconnect_delay_sec = std::max((int)obs_data_get_int(item, "reconnect_delay_sec"), 1);
+	ss.reconnect_max_delay_sec = std::max((int)obs_data_get_int(item, "reconnect_max_delay_sec"), ss.reconnect_delay_sec);
+	ss.health = std::clamp(obs_data_get_double(item, "health"), 0.0, 100.0);
+	ss.adaptive_bitrate = obs_data_get_bool(item, "adaptive_bitrate");
+	ss.bitrate_floor = (int)obs_data_get_int(item, "bitrate_floor");
+	ss.bitrate_ceiling = (int)obs_data_get_int(item, "bitrate_ceiling");
+}
+
 bool CanvasDock::LoadStreamOutputs(obs_data_array_t *outputs)
 {
 	auto count = obs_data_array_count(outputs);
@@ -8733,6 +10831,7 @@ bool CanvasDock::LoadStreamOutputs(obs_data_array_t *outputs)
 				if (it->enabled) {
 					enabled_count++;
 				}
+				load_stream_server_policy(*it, item);
 				obs_data_release(it->settings);
 				it->settings = item;
 				found = true;
@@ -8775,6 +10874,7 @@ bool CanvasDock::LoadStreamOutputs(obs_data_array_t *outputs)
 		if (ss.enabled) {
 			enabled_count++;
 		}
+		load_stream_server_policy(ss, item);
 		std::string service_name = "vertical_canvas_stream_service_";
 		service_name += std::to_string(i);
 		bool whip = strstr(ss.stream_server.c_str(), "whip") != nullptr;
@@ -8799,6 +10899,13 @@ obs_data_array_t *CanvasDock::SaveStreamOutputs()
 		obs_data_set_string(s, "stream_server", it->stream_server.c_str());
 		obs_data_set_string(s, "stream_key", it->stream_key.c_str());
 		obs_data_set_bool(s, "enabled", it->enabled);
+		obs_data_set_int(s, "reconnect_retries", it->reconnect_retries);
+		obs_data_set_int(s, "reconnect_delay_sec", it->reconnect_delay_sec);
+		obs_data_set_int(s, "reconnect_max_delay_sec", it->reconnect_max_delay_sec);
+		obs_data_set_double(s, "health", it->health);
+		obs_data_set_bool(s, "adaptive_bitrate", it->adaptive_bitrate);
+		obs_data_set_int(s, "bitrate_floor", it->bitrate_floor);
+		obs_data_set_int(s, "bitrate_ceiling", it->bitrate_ceiling);
 		obs_data_array_push_back(outputs, s);
 		obs_data_release(s);
 	}
@@ -8819,6 +10926,9 @@ void CanvasDock::StopStreamOutput(std::string name)
 {
 	for (auto it = streamOutputs.begin(); it != streamOutputs.end(); it++) {
 		if (it->name == name) {
+			it->reconnect_pending = false;
+				it->was_live = false;
+			it->reconnect_attempt = 0;
 			if (it->output) {
 				obs_output_stop(it->output);
 			}
@@ -8873,33 +10983,16 @@ void CanvasDock::save_load(obs_data_t *save_data, bool saving, void *param)
 	UNUSED_PARAMETER(save_data);
 	CanvasDock *window = static_cast<CanvasDock *>(param);
 	if (saving) {
-		if (window->scenesDock) {
-			auto c = window->scenesDock->sceneList->count();
-			for (int row = 0; row < c; row++) {
-				auto scene_name = window->scenesDock->sceneList->item(row)->text();
-				auto scene = obs_canvas_get_source_by_name(window->canvas, scene_name.toUtf8().constData());
-				if (scene) {
-					auto settings = obs_source_get_settings(scene);
-					obs_data_set_int(settings, "order", row);
-					obs_data_set_bool(settings, "canvas_active", scene_name == window->currentSceneName);
-					obs_data_release(settings);
-					obs_source_release(scene);
-				}
-			}
-		}
-		if (window->scenesCombo) {
-			auto c = window->scenesCombo->count();
-			for (int row = 0; row < c; row++) {
-				auto scene_name = window->scenesCombo->itemText(row);
-				auto scene = obs_canvas_get_source_by_name(window->canvas, scene_name.toUtf8().constData());
-				if (scene) {
-					auto settings = obs_source_get_settings(scene);
-					obs_data_set_int(settings, "order", row);
-					obs_data_set_bool(settings, "canvas_active", scene_name == window->currentSceneName);
-					obs_data_release(settings);
-					obs_source_release(scene);
-				}
+		auto c = window->sceneModel->rowCount();
+		for (int row = 0; row < c; row++) {
+			OBSSource scene = window->sceneModel->Source(row);
+			if (!scene) {
+				continue;
 			}
+			auto settings = obs_source_get_settings(scene);
+			obs_data_set_int(settings, "order", row);
+			obs_data_set_bool(settings, "canvas_active", window->sceneModel->Name(row) == window->currentSceneName);
+			obs_data_release(settings);
 		}
 	}
 }
@@ -8908,25 +11001,11 @@ void CanvasDock::LogScenes()
 {
 	blog(LOG_INFO, "------------------------------------------------");
 	blog(LOG_INFO, "[Aitum Vertical] Canvas '%s' scenes:", obs_canvas_get_name(canvas));
-	if (scenesDock && scenesDock->sceneList) {
-		for (int j = 0; j < scenesDock->sceneList->count(); j++) {
-			auto item = scenesDock->sceneList->item(j);
-			blog(LOG_INFO, "- scene '%s':", item->text().toUtf8().constData());
-			auto scene = obs_canvas_get_scene_by_name(canvas, item->text().toUtf8().constData());
-			obs_scene_enum_items(scene, LogSceneItem, (void *)(intptr_t)1);
-			obs_source_enum_filters(obs_scene_get_source(scene), LogFilter, (void *)(intptr_t)1);
-
-			obs_scene_release(scene);
-		}
-	} else if (scenesCombo) {
-		for (int j = 0; j < scenesCombo->count(); j++) {
-			auto scene_name = scenesCombo->itemText(j);
-			blog(LOG_INFO, "- scene '%s':", scene_name.toUtf8().constData());
-			auto scene = obs_canvas_get_scene_by_name(canvas, scene_name.toUtf8().constData());
-			obs_scene_enum_items(scene, LogSceneItem, (void *)(intptr_t)1);
-			obs_source_enum_filters(obs_scene_get_source(scene), LogFilter, (void *)(intptr_t)1);
-			obs_scene_release(scene);
-		}
+	for (int j = 0; j < sceneModel->rowCount(); j++) {
+		OBSSource scene = sceneModel->Source(j);
+		blog(LOG_INFO, "- scene '%s':", sceneModel->Name(j).toUtf8().constData());
+		obs_scene_enum_items(obs_scene_from_source(scene), LogSceneItem, (void *)(intptr_t)1);
+		obs_source_enum_filters(scene, LogFilter, (void *)(intptr_t)1);
 	}
 	blog(LOG_INFO, "------------------------------------------------");
 }
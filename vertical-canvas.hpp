@@ -1,7 +1,11 @@
 #pragma once
 
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <obs-frontend-api.h>
 #include <QDockWidget>
 #include <QLabel>
@@ -17,8 +21,10 @@
 #include <graphics/matrix4.h>
 #include <graphics/vec2.h>
 
+#include "backtrack-ring.h"
 #include "config-dialog.hpp"
 #include "obs.hpp"
+#include "projector-type.hpp"
 #include "projector.hpp"
 #include "qt-display.hpp"
 #include "scenes-dock.hpp"
@@ -76,6 +82,47 @@ public:
 	std::string stream_server;
 	bool enabled = true;
 	bool stopping = false;
+	uint64_t start_time = 0;
+	int64_t first_packet_ms = -1;
+	int64_t start_latency_ms = -1;
+	bool connecting = false;
+	int reconnect_retries = 10;
+	int reconnect_delay_sec = 2;
+	int reconnect_max_delay_sec = 60;
+	int reconnect_attempt = 0;
+	bool reconnect_pending = false;
+	bool was_live = false;
+	uint64_t live_since = 0;
+	std::deque<uint64_t> reconnect_history;
+	uint64_t last_total_frames = 0;
+	uint64_t last_dropped_frames = 0;
+	double health = 100.0;
+	double drop_ratio = 0.0;
+	bool adaptive_bitrate = false;
+	int bitrate_floor = 0;
+	int bitrate_ceiling = 0;
+	int current_bitrate = 0;
+	int configured_bitrate = 0;
+	int bitrate_congested_ticks = 0;
+	int bitrate_clear_ticks = 0;
+};
+
+class DerivedCanvas {
+public:
+	obs_canvas_t *canvas = nullptr;
+	obs_source_t *source = nullptr;
+	obs_output_t *recordOutput = nullptr;
+	obs_encoder_t *videoEncoder = nullptr;
+	std::string name;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	bool record = true;
+};
+
+class BacktrackSave {
+public:
+	QString filename;
+	uint32_t seconds = 0;
 };
 
 class CanvasDock : public QFrame {
@@ -95,6 +142,11 @@ private:
 	QVBoxLayout *mainLayout;
 	OBSQTDisplay *preview;
 	bool preview_disabled = false;
+	bool show_stats = false;
+	QLabel *statsLabel;
+	std::mutex statsMutex;
+	obs_data_t *stats = nullptr;
+	std::map<obs_output_t *, std::pair<uint64_t, uint64_t>> statsOutputBytes;
 	QFrame *previewDisabledWidget;
 	QPushButton *configButton;
 	OBSWeakSource source;
@@ -145,11 +197,22 @@ private:
 	bool switching = false;
 	obs_scene_t *scene = nullptr;
 	obs_canvas_t *canvas = nullptr;
+	std::unordered_map<obs_source_t *, bool> cycleCache;
+	long cycleCacheGeneration = -1;
+	obs_source_t *cycleCacheScene = nullptr;
+	obs_weak_source_t *cycleCacheSource = nullptr;
 	obs_canvas_t *multiCanvas = nullptr;
 	video_t *multiCanvasVideo = nullptr;
 	obs_source_t *multiCanvasSource = nullptr;
 	gs_texrender_t *texrender = nullptr;
 	gs_stagesurf_t *stagesurface = nullptr;
+	std::mutex thumbnailMutex;
+	std::vector<OBSWeakSource> thumbnailScenes;
+	size_t thumbnailIndex = 0;
+	OBSWeakSource thumbnailPending;
+	uint64_t thumbnailNext = 0;
+	bool thumbnailsActive = false;
+	bool thumbnailScenesPending = false;
 	QPushButton *virtualCamButton;
 	QPushButton *recordButton;
 	QIcon recordActiveIcon = QIcon(":/aitum/media/recording.svg");
@@ -159,7 +222,12 @@ private:
 	QCheckBox *replayEnable;
 	QLabel *statusLabel;
 	QTimer replayStatusResetTimer;
+	QTimer replaySaveTimeoutTimer;
 	QTimer recordDurationTimer;
+	QTimer streamStartTimer;
+	QTimer prewarmTimer;
+	QTimer prewarmDwellTimer;
+	OBSWeakSource prewarmHoverSource;
 	QPushButton *streamButton;
 	QPushButton *streamButtonMulti;
 	QIcon streamActiveIcon = QIcon(":/aitum/media/streaming.svg");
@@ -170,6 +238,7 @@ private:
 
 	QIcon virtualCamActiveIcon = QIcon(":/aitum/media/virtual_cam_on.svg");
 	QIcon virtualCamInactiveIcon = QIcon(":/aitum/media/virtual_cam_off.svg");
+	CanvasScenesModel *sceneModel = nullptr;
 	QComboBox *scenesCombo = nullptr;
 	QCheckBox *linkedButton = nullptr;
 	CanvasScenesDock *scenesDock = nullptr;
@@ -188,11 +257,18 @@ private:
 	obs_hotkey_pair_id preview_hotkey = OBS_INVALID_HOTKEY_PAIR_ID;
 	obs_hotkey_id chapter_hotkey = OBS_INVALID_HOTKEY_ID;
 	obs_hotkey_id split_hotkey = OBS_INVALID_HOTKEY_ID;
+	obs_hotkey_id save_disk_backtrack_hotkey = OBS_INVALID_HOTKEY_ID;
 
 	obs_output_t *virtualCamOutput = nullptr;
 	obs_output_t *recordOutput = nullptr;
 	obs_output_t *replayOutput = nullptr;
+	obs_output_t *diskReplayOutput = nullptr;
+	backtrack_ring_t *diskReplayRing = nullptr;
 
+	std::string dock_id;
+	std::string canvas_name;
+	std::string canvas_uuid;
+	std::string dock_title;
 	uint32_t canvas_width;
 	uint32_t canvas_height;
 	bool restart_video = false;
@@ -206,8 +282,41 @@ private:
 	uint32_t replayDuration;
 	std::string replayPath;
 	std::string replayFilename;
+	bool replayDisk = false;
+	std::deque<BacktrackSave> replaySaveQueue;
+	bool replaySaving = false;
+	uint64_t replaySaveStart = 0;
+	uint32_t replaySaveSeconds = 0;
 
 	std::vector<StreamServer> streamOutputs;
+	bool streamArmed = false;
+	bool streamArmedVideo = false;
+	QTimer streamFirstPacketTimer;
+	int stream_start_parallel = 0;
+	int stream_start_stagger_ms = 0;
+	int scene_prewarm_ttl_ms = 5000;
+
+	struct PrewarmedScene {
+		OBSSource source;
+		uint64_t expires;
+	};
+	std::map<std::string, PrewarmedScene> prewarmedScenes;
+
+	struct LinkedScene {
+		OBSWeakSource main;
+		OBSWeakSource linked;
+	};
+	std::unordered_map<std::string, LinkedScene> linkedScenes;
+	uint64_t linkedSwitchCount = 0;
+	uint64_t linkedSwitchLateCount = 0;
+	uint64_t linkedSwitchLastHandlerNs = 0;
+	uint64_t linkedSwitchMaxHandlerNs = 0;
+	std::deque<size_t> streamStartPending;
+	int streamStartConnecting = 0;
+	bool streamStartBatch = false;
+	bool streamStartVideo = false;
+	QStringList streamStartFailures;
+	std::vector<DerivedCanvas> derivedCanvases;
 
 	bool stream_delay_enabled;
 	uint32_t stream_delay_duration;
@@ -230,6 +339,8 @@ private:
 	uint32_t virtual_cam_mode = 0;
 	uint32_t max_size_mb = 0;
 	uint32_t max_time_sec = 0;
+	uint32_t record_write_buffer_mb = 0;
+	uint64_t recordStartTime = 0;
 
 	QString currentSceneName;
 	bool first_time = false;
@@ -246,8 +357,16 @@ private:
 
 	gs_vertbuffer_t *box = nullptr;
 
-	OBSSourceAutoRelease spacerLabel[4];
-	int spacerPx[4] = {0};
+	struct SpacerGlyph {
+		uint32_t x = 0;
+		uint32_t cx = 0;
+		float advance = 0.0f;
+	};
+	gs_texture_t *spacerAtlas = nullptr;
+	float spacerAtlasRatio = 0.0f;
+	uint32_t spacerAtlasHeight = 0;
+	float spacerAtlasPad = 0.0f;
+	SpacerGlyph spacerGlyphs[13];
 
 	inline bool IsFixedScaling() const { return fixedScaling; }
 
@@ -270,6 +389,10 @@ private:
 	QMenu *CreateAddSourcePopupMenu();
 	void AddSceneItemMenuItems(QMenu *popup, OBSSceneItem sceneItem);
 	void LoadSourceTypeMenu(QMenu *menu, const char *type);
+	void AddSourcesToMenu(QMenu *menu, std::vector<OBSSource> &sources);
+	bool WouldCreateCycle(obs_source_t *s);
+	void RegisterSceneHotkeys(obs_source_t *scene);
+	void ExpirePrewarmedScenes(bool all);
 	QMenu *CreateVisibilityTransitionMenu(bool visible, obs_sceneitem_t *sceneItem);
 	QIcon GetIconFromType(enum obs_icon_type icon_type) const;
 	QIcon GetGroupIcon() const;
@@ -283,7 +406,9 @@ private:
 	void DrawSpacingHelpers(obs_scene_t *scene, float x, float y, float cx, float cy, float scale, float sourceX,
 				float sourceY);
 	void DrawSpacingLine(vec3 &start, vec3 &end, vec3 &viewport, float pixelRatio);
-	void SetLabelText(int sourceIndex, int px);
+	void CreateSpacerAtlas(float pixelRatio);
+	float GetSpacerLabelWidth(const char *text) const;
+	void DrawSpacerLabel(const char *text, vec3 &pos, vec3 &viewport);
 	void RenderSpacingHelper(int sourceIndex, vec3 &start, vec3 &end, vec3 &viewport, float pixelRatio);
 	bool GetSourceRelativeXY(int mouseX, int mouseY, int &relX, int &relY);
 
@@ -315,22 +440,49 @@ private:
 	void AddSourceTypeToMenu(QMenu *popup, const char *source_type, const char *name);
 
 	bool StartVideo();
+	bool StartDerivedVideo(DerivedCanvas &dc);
+	void ReleaseDerivedCanvas(DerivedCanvas &dc);
+	void StopIdleDerivedVideo();
+	void StartDerivedRecord();
+	void StopDerivedRecord();
 	void HandleRecordError(int code, QString last_error);
 
 	void CreateScenesRow();
 	void AddScene(QString duplicate = "", bool ask_name = true);
 	void RemoveScene(const QString &sceneName);
 	void SetLinkedScene(obs_source_t *scene, const QString &linkedScene);
+	bool IsLinkedEntry(obs_data_t *item) const;
+	bool GetLinkedSceneName(obs_source_t *main_scene, std::string &linked_name) const;
+	void UpdateLinkedScene(obs_source_t *main_scene, const char *linked_name);
+	OBSSource GetLinkedScene(obs_source_t *main_scene) const;
+	void RebuildLinkedScenes();
 	bool HasScene(QString scene) const;
+	void SetCurrentSceneRow(int row);
+	void SetSceneThumbnails(bool enable);
+	QSize GetThumbnailSize() const;
 	void CheckReplayBuffer(bool start = false);
-	void SendVendorEvent(const char *e);
+	void SendVendorEvent(const char *e, obs_data_t *extra = nullptr);
+	void SendBacktrackSaveCompleted(const char *path, uint64_t bytes, uint64_t duration_ns, uint32_t seconds);
+	void StartNextReplaySave();
+	void ReplaySaveTimedOut();
 	void DeleteProjector(OBSProjector *projector);
-	OBSProjector *OpenProjector(int monitor);
+	OBSProjector *OpenProjector(int monitor, ProjectorType type = ProjectorType::Preview);
+	void UpdateMultiviews();
 	void AddProjectorMenuMonitors(QMenu *parent, QObject *target, const char *slot);
 
 	void TryRemux(QString path);
 	void StartStreamOutput(std::vector<StreamServer>::iterator it);
 	void CreateStreamOutput(std::vector<StreamServer>::iterator it);
+	bool PrepareStreamOutputs();
+	void StreamOutputStarted(obs_output_t *output, uint64_t time);
+	void CheckStreamStartBatch();
+	bool ScheduleStreamReconnect(std::vector<StreamServer>::iterator it);
+	void ReconnectStreamOutput(obs_output_t *output);
+	void UpdateStreamHealth();
+	obs_encoder_t *GetAdaptiveVideoEncoder(std::vector<StreamServer>::iterator it, obs_encoder_t *shared);
+	void UpdateAdaptiveBitrate();
+	void SampleStats();
+	obs_data_t *SampleOutputStats(obs_output_t *output, uint64_t now);
 
 	void StreamButtonMultiMenu(QMenu *menu);
 
@@ -340,21 +492,30 @@ private:
 	static bool DrawSelectedOverflow(obs_scene_t *scene, obs_sceneitem_t *item, void *param);
 	static bool FindSelected(obs_scene_t *scene, obs_sceneitem_t *item, void *param);
 	static void DrawPreview(void *data, uint32_t cx, uint32_t cy);
+	static void RenderSceneThumbnail(void *data, uint32_t cx, uint32_t cy);
+	void DownloadSceneThumbnail();
+	void UpdateThumbnailScenes();
 	static bool DrawSelectedItem(obs_scene_t *scene, obs_sceneitem_t *item, void *param);
-	static bool add_sources_of_type_to_menu(void *param, obs_source_t *source);
 
 	static void virtual_cam_output_start(void *p, calldata_t *calldata);
 	static void virtual_cam_output_stop(void *p, calldata_t *calldata);
 	static void record_output_start(void *p, calldata_t *calldata);
 	static void record_output_stop(void *p, calldata_t *calldata);
+	static void derived_record_output_stop(void *p, calldata_t *calldata);
 	static void record_output_stopping(void *p, calldata_t *calldata);
 	static void replay_output_start(void *p, calldata_t *calldata);
 	static void replay_output_stop(void *p, calldata_t *calldata);
 	static void replay_saved(void *p, calldata_t *calldata);
+	static void disk_replay_file_changed(void *p, calldata_t *calldata);
+	static void remux_progress(void *param, const char *path, int percent);
+	static void remux_finished(void *param, const char *path, const char *output, bool success);
+	static void disk_replay_saved(void *param, const char *path, bool success, uint64_t bytes, uint64_t duration_ns,
+				      uint32_t seconds);
 	static void stream_output_start(void *p, calldata_t *calldata);
 	static void stream_output_stop(void *p, calldata_t *calldata);
 	static void source_rename(void *p, calldata_t *calldata);
 	static void source_remove(void *p, calldata_t *calldata);
+	static void source_create(void *p, calldata_t *calldata);
 	static void source_save(void *p, calldata_t *calldata);
 	static bool start_virtual_cam_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed);
 	static bool stop_virtual_cam_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed);
@@ -368,6 +529,7 @@ private:
 	static bool hide_preview_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed);
 	static void recording_chapter_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
 	static void recording_split_hotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
+	static void save_disk_backtrack_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
 
 	static void SceneItemAdded(void *data, calldata_t *params);
 	static void SceneReordered(void *data, calldata_t *params);
@@ -385,6 +547,7 @@ private slots:
 	void AddSourceFromAction();
 	void VirtualCamButtonClicked();
 	void ReplayButtonClicked(QString filename = "");
+	void SaveBacktrack(QString filename, int seconds);
 	void RecordButtonClicked();
 	void StreamButtonClicked();
 	void ConfigButtonClicked();
@@ -393,16 +556,21 @@ private slots:
 	void OnRecordStart();
 	void OnRecordStop(int code, QString last_error);
 	void OnReplaySaved();
+	void OnBacktrackFileSaved(QString path);
+	void OnRemuxProgress(int percent);
+	void OnRemuxFinished(bool success);
 	void OnStreamStart();
 	void OnStreamStop(int code, QString last_error, QString stream_server, QString stream_key);
 	void OnReplayBufferStart();
 	void OnReplayBufferStop(int code, QString last_error);
 	void SwitchScene(const QString &scene_name, bool transition = true);
+	void PrewarmScene(const QString &scene_name);
 	obs_source_t *GetTransition(const char *transition_name);
 	bool SwapTransition(obs_source_t *transition);
 	void StartVirtualCam();
 	void StopVirtualCam();
-	void SetRecordAudioEncoders(obs_output_t *output);
+	void SetRecordAudioEncoders(obs_output_t *output, bool share_main = false);
+	void LogAudioEncoderGraph(obs_output_t *output);
 	obs_encoder_t *GetRecordVideoEncoder();
 	obs_encoder_t *GetStreamVideoEncoder();
 	obs_encoder_t *GetStreamAudioEncoder();
@@ -410,9 +578,15 @@ private slots:
 	void StartRecord();
 	void StopRecord();
 	void StartReplayBuffer();
+	obs_output_t *PrepareDiskReplayOutput();
+	void SaveDiskReplay(const QString &filename, uint32_t seconds);
 	void StopReplayBuffer();
 	void StartStream();
 	void StopStream();
+	void ArmStream();
+	void DisarmStream();
+	void CheckStreamFirstPacket();
+	void StartNextStreamOutputs();
 	void AddSceneItem(OBSSceneItem item);
 	void RefreshSources(OBSScene scene);
 	void ReorderSources(OBSScene scene);
@@ -428,6 +602,7 @@ private slots:
 	void MainVirtualCamStop();
 	void ProfileChanged();
 	void OpenPreviewProjector();
+	void OpenMultiviewProjector();
 	void OpenSourceProjector();
 	void SwitchBackToSelectedTransition();
 	void SceneRemoved(const QString name);
@@ -448,12 +623,20 @@ public:
 	void FinishLoading();
 	void setAction(QAction *action);
 	CanvasScenesDock *GetScenesDock();
+	inline const std::string &GetDockId() const { return dock_id; }
+	inline const std::string &GetCanvasName() const { return canvas_name; }
+	inline const char *GetCanvasUuid() const { return canvas_uuid.c_str(); }
+	bool MatchesCanvas(const char *uuid, long long width, long long height) const;
 	inline uint32_t GetCanvasWidth() const { return canvas_width; }
 	inline uint32_t GetCanvasHeight() const { return canvas_height; }
 	inline video_t *GetVideo() const { return obs_canvas_get_video(canvas); }
 	inline QString GetScene() const { return currentSceneName; }
 	bool LoadStreamOutputs(obs_data_array_t *outputs);
 	obs_data_array_t *SaveStreamOutputs();
+	void LoadDerivedCanvases(obs_data_array_t *derived);
+	obs_data_array_t *SaveDerivedCanvases();
+	void UpdateDerivedCanvases();
+	video_t *GetDerivedVideo(uint32_t width, uint32_t height);
 	void StartStreamOutput(std::string name);
 	void StopStreamOutput(std::string name);
 	obs_output_t *GetStreamOutput(std::string name);
@@ -466,10 +649,17 @@ public:
 	obs_scene_t *GetCurrentScene();
 	std::vector<QString> GetScenes();
 	bool StreamingActive();
+	inline bool StreamArmed() const { return streamArmed; }
 	bool RecordingActive();
+	obs_data_t *GetRecordStats();
+	obs_data_array_t *GetStreamStats();
+	obs_data_t *GetStats();
 	bool BacktrackActive();
 	bool VirtualCameraActive();
 	void AskUpdate();
+	void PrewarmSource(obs_source_t *scene_source);
+	void HoverPrewarmSource(obs_source_t *scene_source);
+	void MainTransitionStarted(obs_source_t *transition, uint64_t start_ns, uint64_t frame_time);
 };
 
 class LockedCheckBox : public QCheckBox {